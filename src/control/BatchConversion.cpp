@@ -0,0 +1,235 @@
+#include "BatchConversion.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "control/jobs/ProgressListener.h"
+#include "control/xojfile/LoadHandler.h"
+#include "model/Document.h"
+#include "pdf/base/XojPdfExport.h"
+#include "pdf/base/XojPdfExportFactory.h"
+
+#include "PageRange.h"
+#include "StringUtils.h"
+#include "i18n.h"
+
+BatchConversion::BatchConversion(const char* range, int pngDpi, int pngWidth, int pngHeight, bool noBackground,
+                                 bool presentationMode):
+        range(range),
+        pngDpi(pngDpi),
+        pngWidth(pngWidth),
+        pngHeight(pngHeight),
+        noBackground(noBackground),
+        presentationMode(presentationMode) {}
+
+BatchConversion::~BatchConversion() = default;
+
+auto BatchConversion::run(const fs::path& manifest, int threads) -> int {
+    std::ifstream file;
+    if (manifest == "-") {
+        this->input = &std::cin;
+    } else {
+        file.open(manifest);
+        if (!file.is_open()) {
+            g_warning("%s", FC(_F("Could not open the batch manifest \"{1}\"") % manifest.u8string()));
+            return -2;
+        }
+        this->input = &file;
+    }
+
+    if (threads <= 0) {
+        threads = static_cast<int>(g_get_num_processors());
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&BatchConversion::worker, this);
+    }
+    for (std::thread& t: workers) {
+        t.join();
+    }
+
+    this->input = nullptr;
+
+    g_message("%s", FC(_F("Batch conversion finished: {1} converted, {2} failed") % this->succeeded % this->failed));
+
+    return this->failed == 0 ? 0 : -3;
+}
+
+auto BatchConversion::nextTask(Task& task) -> bool {
+    std::lock_guard<std::mutex> lock(this->inputMutex);
+
+    string line;
+    while (std::getline(*this->input, line)) {
+        this->lineNumber++;
+
+        // Manifests written on Windows
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        task.line = this->lineNumber;
+        size_t tab = line.find('\t');
+        if (tab == string::npos) {
+            // Reported as error by convert()
+            task.input = line;
+            task.output.clear();
+        } else {
+            task.input = line.substr(0, tab);
+            task.output = line.substr(tab + 1);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void BatchConversion::worker() {
+    // The loader keeps its buffers between the documents
+    LoadHandler loader;
+
+    Task task;
+    while (nextTask(task)) {
+        gint64 start = g_get_monotonic_time();
+
+        string error;
+        if (!convert(loader, task, error) && error.empty()) {
+            error = _("Unknown error");
+        }
+
+        report(task, error, g_get_monotonic_time() - start);
+    }
+}
+
+auto BatchConversion::convert(LoadHandler& loader, const Task& task, string& error) -> bool {
+    if (task.output.empty()) {
+        error = _("Expected \"<input>\\t<output>\"");
+        return false;
+    }
+
+    Document* doc = loader.loadDocument(task.input);
+    if (doc == nullptr) {
+        error = loader.getLastError();
+        return false;
+    }
+
+    fs::path output = fs::absolute(fs::u8path(task.output));
+    string ext = StringUtils::toLowerCase(output.extension().u8string());
+    if (ext == ".pdf") {
+        return exportPdf(doc, output, error);
+    }
+    if (ext == ".png") {
+        return exportImg(doc, output, EXPORT_GRAPHICS_PNG, error);
+    }
+    if (ext == ".svg") {
+        return exportImg(doc, output, EXPORT_GRAPHICS_SVG, error);
+    }
+
+    error = FS(_F("Unsupported output format \"{1}\"") % ext);
+    return false;
+}
+
+auto BatchConversion::exportPdf(Document* doc, const fs::path& output, string& error) -> bool {
+    std::unique_ptr<XojPdfExport> pdfe(XojPdfExportFactory::createExport(doc, nullptr));
+    pdfe->setNoBackgroundExport(this->noBackground);
+
+    bool success = false;
+    if (this->range) {
+        PageRangeVector exportRange = PageRange::parse(this->range, doc->getPageCount());
+        success = pdfe->createPdf(output, exportRange, this->presentationMode);
+        for (PageRangeEntry* e: exportRange) {
+            delete e;
+        }
+    } else {
+        success = pdfe->createPdf(output, this->presentationMode);
+    }
+
+    if (!success) {
+        error = pdfe->getLastError();
+    }
+    return success;
+}
+
+auto BatchConversion::exportImg(Document* doc, const fs::path& output, ExportGraphicsFormat format, string& error)
+        -> bool {
+    PageRangeVector exportRange;
+    if (this->range) {
+        exportRange = PageRange::parse(this->range, int(doc->getPageCount()));
+    } else {
+        exportRange.push_back(new PageRangeEntry(0, int(doc->getPageCount() - 1)));
+    }
+
+    DummyProgressListener progress;
+    ImageExport imgExport(doc, output, format, this->noBackground, exportRange);
+
+    if (format == EXPORT_GRAPHICS_PNG) {
+        if (this->pngDpi > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_DPI, this->pngDpi);
+        } else if (this->pngWidth > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_WIDTH, this->pngWidth);
+        } else if (this->pngHeight > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_HEIGHT, this->pngHeight);
+        }
+    }
+
+    imgExport.exportGraphics(&progress);
+
+    for (PageRangeEntry* e: exportRange) {
+        delete e;
+    }
+
+    error = imgExport.getLastErrorMsg();
+    return error.empty();
+}
+
+void BatchConversion::report(const Task& task, const string& error, gint64 durationUs) {
+    std::ostringstream status;
+    status << R"({"line":)" << task.line << R"(,"input":")" << jsonEscape(task.input) << R"(","output":")"
+           << jsonEscape(task.output) << R"(","status":)";
+    if (error.empty()) {
+        status << R"("ok")";
+    } else {
+        status << R"("error","error":")" << jsonEscape(error) << "\"";
+    }
+    status << R"(,"ms":)" << durationUs / 1000 << "}\n";
+
+    std::lock_guard<std::mutex> lock(this->outputMutex);
+    if (error.empty()) {
+        this->succeeded++;
+    } else {
+        this->failed++;
+    }
+
+    // Flushed for each file, so the caller can follow the progress
+    std::cout << status.str() << std::flush;
+}
+
+auto BatchConversion::jsonEscape(const string& str) -> string {
+    string escaped;
+    escaped.reserve(str.size());
+
+    for (char c: str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            escaped += buffer;
+        } else {
+            // UTF-8 is valid in JSON strings
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
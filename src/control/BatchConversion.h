@@ -0,0 +1,102 @@
+/*
+ * Xournal++
+ *
+ * Converts many documents to PDF or images in one process
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <istream>
+#include <mutex>
+#include <string>
+
+#include <glib.h>
+
+#include "control/jobs/ImageExport.h"
+
+#include "XournalType.h"
+#include "filesystem.h"
+
+class Document;
+class LoadHandler;
+
+/**
+ * Reads a manifest with one conversion per line, "<input>\t<output>". Empty lines and lines starting
+ * with '#' are skipped. The output format is guessed from the extension of the output: .pdf, .png or .svg.
+ *
+ * The lines are read while the conversion is running, so the manifest can also be a pipe. For each line
+ * a status object is written to stdout as a single line of JSON:
+ *
+ *  {"line":3,"input":"a.xopp","output":"a.pdf","status":"ok","ms":120}
+ *  {"line":4,"input":"b.xopp","output":"b.pdf","status":"error","error":"...","ms":5}
+ *
+ * A failing file does not stop the batch.
+ */
+class BatchConversion {
+public:
+    /**
+     * The options are the same as for a single export, they apply to all files
+     */
+    BatchConversion(const char* range, int pngDpi, int pngWidth, int pngHeight, bool noBackground,
+                    bool presentationMode);
+    virtual ~BatchConversion();
+
+public:
+    /**
+     * @param manifest The manifest file, "-" to read from stdin
+     * @param threads The count of worker threads, if <= 0 one per processor
+     *
+     * @return 0 if all files were converted, -2 if the manifest could not be opened, -3 if a conversion failed
+     */
+    int run(const fs::path& manifest, int threads);
+
+private:
+    struct Task {
+        size_t line = 0;
+        string input;
+        string output;
+    };
+
+    /**
+     * Reads the next conversion from the manifest, thread safe
+     *
+     * @return false if the end of the manifest is reached
+     */
+    bool nextTask(Task& task);
+
+    void worker();
+    bool convert(LoadHandler& loader, const Task& task, string& error);
+    bool exportPdf(Document* doc, const fs::path& output, string& error);
+    bool exportImg(Document* doc, const fs::path& output, ExportGraphicsFormat format, string& error);
+
+    void report(const Task& task, const string& error, gint64 durationUs);
+
+    static string jsonEscape(const string& str);
+
+private:
+    const char* range = nullptr;
+    int pngDpi = -1;
+    int pngWidth = -1;
+    int pngHeight = -1;
+    bool noBackground = false;
+    bool presentationMode = false;
+
+    /**
+     * Protects reading the manifest
+     */
+    std::mutex inputMutex;
+    std::istream* input = nullptr;
+    size_t lineNumber = 0;
+
+    /**
+     * Protects the status output and the counters
+     */
+    std::mutex outputMutex;
+    size_t succeeded = 0;
+    size_t failed = 0;
+};
@@ -1,14 +1,17 @@
 #include "ClipboardHandler.h"
 
+#include <cmath>
 #include <utility>
 
 #include <cairo-svg.h>
 #include <config.h>
 
+#include "model/Text.h"
 #include "serializing/BinObjectEncoding.h"
 #include "serializing/ObjectInputStream.h"
 #include "serializing/ObjectOutputStream.h"
 #include "view/DocumentView.h"
+#include "view/ElementContainer.h"
 
 #include "Control.h"
 #include "Util.h"
@@ -69,19 +72,44 @@ auto ElementCompareFunc(Element* a, Element* b) -> gint {
 static GdkAtom atomSvg1 = gdk_atom_intern_static_string("image/svg");
 static GdkAtom atomSvg2 = gdk_atom_intern_static_string("image/svg+xml");
 
-// The contents of the clipboard
-class ClipboardContents {
+static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * Larger selections are rasterized with less than 300 dpi
+ */
+constexpr double MAX_IMAGE_PIXELS = 4096.0 * 4096.0;
+
+/**
+ * The contents of the clipboard
+ *
+ * Only the serialized selection and copies of the elements are created on copying, the PNG and SVG
+ * images are rendered the first time another application requests them.
+ */
+class ClipboardContents: public ElementContainer {
 public:
-    ClipboardContents(string text, GdkPixbuf* image, string svg, GString* str) {
+    ClipboardContents(string text, GString* str, vector<Element*> elements, double x, double y, double width,
+                      double height) {
         this->text = std::move(text);
-        this->image = image;
-        this->svg = std::move(svg);
         this->str = str;
+        this->elements = std::move(elements);
+        this->x = x;
+        this->y = y;
+        this->width = width;
+        this->height = height;
     }
 
-    ~ClipboardContents() {
-        g_object_unref(this->image);
+    ~ClipboardContents() override {
+        if (this->image) {
+            g_object_unref(this->image);
+        }
         g_string_free(this->str, true);
+
+        for (Element* e: this->elements) {
+            delete e;
+        }
     }
 
 
@@ -94,10 +122,13 @@ public:
         } else if (target == gdk_atom_intern_static_string("image/png") ||
                    target == gdk_atom_intern_static_string("image/jpeg") ||
                    target == gdk_atom_intern_static_string("image/gif")) {
-            gtk_selection_data_set_pixbuf(selection, contents->image);
+            GdkPixbuf* image = contents->getImage();
+            if (image) {
+                gtk_selection_data_set_pixbuf(selection, image);
+            }
         } else if (atomSvg1 == target || atomSvg2 == target) {
-            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(contents->svg.c_str()),
-                                   contents->svg.length());
+            const string& svg = contents->getSvg();
+            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(svg.c_str()), svg.length());
         } else if (atomXournal == target) {
             gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar*>(contents->str->str),
                                    contents->str->len);
@@ -106,17 +137,90 @@ public:
 
     static void clearFunction(GtkClipboard* clipboard, ClipboardContents* contents) { delete contents; }
 
+    vector<Element*>* getElements() override { return &this->elements; }
+
+private:
+    GdkPixbuf* getImage() {
+        if (this->image || this->elements.empty()) {
+            return this->image;
+        }
+
+        DocumentView view;
+
+        double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
+        double pixels = this->width * dpiFactor * this->height * dpiFactor;
+        if (pixels > MAX_IMAGE_PIXELS) {
+            dpiFactor *= std::sqrt(MAX_IMAGE_PIXELS / pixels);
+        }
+
+        int width = this->width * dpiFactor;
+        int height = this->height * dpiFactor;
+        cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        cairo_t* crPng = cairo_create(surfacePng);
+        cairo_scale(crPng, dpiFactor, dpiFactor);
+
+        cairo_translate(crPng, -this->x, -this->y);
+        view.drawSelection(crPng, this);
+
+        cairo_destroy(crPng);
+
+        this->image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
+
+        cairo_surface_destroy(surfacePng);
+
+        return this->image;
+    }
+
+    const string& getSvg() {
+        if (this->svgRendered) {
+            return this->svg;
+        }
+        this->svgRendered = true;
+
+        if (this->elements.empty()) {
+            return this->svg;
+        }
+
+        DocumentView view;
+        GString* svgString = g_string_new("");
+
+        cairo_surface_t* surfaceSVG = cairo_svg_surface_create_for_stream(
+                reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString, this->width, this->height);
+        cairo_t* crSVG = cairo_create(surfaceSVG);
+
+        cairo_translate(crSVG, -this->x, -this->y);
+        view.drawSelection(crSVG, this);
+
+        cairo_surface_destroy(surfaceSVG);
+        cairo_destroy(crSVG);
+
+        this->svg = string(svgString->str, svgString->len);
+        g_string_free(svgString, true);
+
+        return this->svg;
+    }
+
 private:
     string text;
-    GdkPixbuf* image;
-    string svg;
     GString* str;
-};
 
-static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
-    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
-    return CAIRO_STATUS_SUCCESS;
-}
+    /**
+     * Position and size of the selection
+     */
+    double x;
+    double y;
+    double width;
+    double height;
+
+    /**
+     * Copies of the selected elements, the selection can be changed after copying
+     */
+    vector<Element*> elements;
+
+    GdkPixbuf* image = nullptr;
+    string svg;
+    bool svgRendered = false;
+};
 
 auto ClipboardHandler::copy() -> bool {
     if (!this->selection) {
@@ -133,6 +237,12 @@ auto ClipboardHandler::copy() -> bool {
 
     this->selection->serialize(out);
 
+    vector<Element*> elements;
+    elements.reserve(this->selection->getElements()->size());
+    for (Element* e: *this->selection->getElements()) {
+        elements.push_back(e->clone());
+    }
+
     /////////////////////////////////////////////////////////////////
     // prepare text contents
     /////////////////////////////////////////////////////////////////
@@ -155,45 +265,6 @@ auto ClipboardHandler::copy() -> bool {
     }
     g_list_free(textElements);
 
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: PNG
-    /////////////////////////////////////////////////////////////////
-
-    DocumentView view;
-
-    double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
-
-    int width = selection->getWidth() * dpiFactor;
-    int height = selection->getHeight() * dpiFactor;
-    cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crPng = cairo_create(surfacePng);
-    cairo_scale(crPng, dpiFactor, dpiFactor);
-
-    cairo_translate(crPng, -selection->getXOnView(), -selection->getYOnView());
-    view.drawSelection(crPng, this->selection);
-
-    cairo_destroy(crPng);
-
-    GdkPixbuf* image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
-
-    cairo_surface_destroy(surfacePng);
-
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: SVG
-    /////////////////////////////////////////////////////////////////
-
-    GString* svgString = g_string_sized_new(1048576);  // 1MB
-
-    cairo_surface_t* surfaceSVG =
-            cairo_svg_surface_create_for_stream(reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString,
-                                                selection->getWidth(), selection->getHeight());
-    cairo_t* crSVG = cairo_create(surfaceSVG);
-
-    view.drawSelection(crSVG, this->selection);
-
-    cairo_surface_destroy(surfaceSVG);
-    cairo_destroy(crSVG);
-
     /////////////////////////////////////////////////////////////////
     // copy to clipboard
     /////////////////////////////////////////////////////////////////
@@ -206,7 +277,7 @@ auto ClipboardHandler::copy() -> bool {
     if (!text.empty()) {
         gtk_target_list_add_text_targets(list, 0);
     }
-    // we always copy an image to clipboard
+    // we always copy an image to clipboard, it is rendered on request
     gtk_target_list_add_image_targets(list, 0, true);
     gtk_target_list_add(list, atomSvg1, 0, 0);
     gtk_target_list_add(list, atomSvg2, 0, 0);
@@ -214,7 +285,8 @@ auto ClipboardHandler::copy() -> bool {
 
     targets = gtk_target_table_new_from_list(list, &n_targets);
 
-    auto* contents = new ClipboardContents(text, image, svgString->str, out.getStr());
+    auto* contents = new ClipboardContents(text, out.getStr(), std::move(elements), selection->getXOnView(),
+                                           selection->getYOnView(), selection->getWidth(), selection->getHeight());
 
     gtk_clipboard_set_with_data(this->clipboard, targets, n_targets,
                                 reinterpret_cast<GtkClipboardGetFunc>(ClipboardContents::getFunction),
@@ -224,8 +296,6 @@ auto ClipboardHandler::copy() -> bool {
     gtk_target_table_free(targets, n_targets);
     gtk_target_list_unref(list);
 
-    g_string_free(svgString, true);
-
     return true;
 }
 
@@ -26,6 +26,8 @@
 #include "jobs/PdfExportJob.h"
 #include "jobs/SaveJob.h"
 #include "layer/LayerController.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
 #include "model/StrokeStyle.h"
 #include "pagetype/PageTypeHandler.h"
 #include "plugin/PluginController.h"
@@ -37,6 +39,7 @@
 #include "undo/DeleteUndoAction.h"
 #include "undo/InsertDeletePageUndoAction.h"
 #include "undo/InsertUndoAction.h"
+#include "undo/SimplifyUndoAction.h"
 #include "view/TextView.h"
 #include "xojfile/LoadHandler.h"
 
@@ -46,8 +49,10 @@
 #include "PageBackgroundChangeController.h"
 #include "PathUtil.h"
 #include "PrintHandler.h"
+#include "SearchIndex.h"
 #include "Stacktrace.h"
 #include "StringUtils.h"
+#include "ThumbnailCache.h"
 #include "UndoRedoController.h"
 #include "Util.h"
 #include "XojMsgBox.h"
@@ -91,6 +96,10 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath): gtkApp
 
     this->doc = new Document(this);
 
+    this->searchIndex = new SearchIndex(this);
+    this->searchIndex->registerListener(this);
+    this->undoRedo->addUndoRedoListener(this->searchIndex);
+
     // for crashhandling
     setEmergencyDocument(this->doc);
 
@@ -125,6 +134,7 @@ Control::~Control() {
 
     deleteLastAutosaveFile("");
     this->scheduler->stop();
+    ThumbnailCache::prune();
     this->changedPages.clear();  // can be removed, will be done by implicit destructor
 
     delete this->pluginController;
@@ -145,6 +155,8 @@ Control::~Control() {
     this->doc = nullptr;
     delete this->searchBar;
     this->searchBar = nullptr;
+    delete this->searchIndex;
+    this->searchIndex = nullptr;
     delete this->scrollHandler;
     this->scrollHandler = nullptr;
     delete this->newPageType;
@@ -474,6 +486,9 @@ void Control::actionPerformed(ActionType type, ActionGroup group, GdkEvent* even
         case ACTION_PAPER_BACKGROUND_COLOR:
             changePageBackgroundColor();
             break;
+        case ACTION_SIMPLIFY_STROKES:
+            simplifyDocumentStrokes();
+            break;
 
             // Menu Tools
         case ACTION_TOOL_PEN:
@@ -1366,6 +1381,45 @@ void Control::changePageBackgroundColor() {
     }
 }
 
+void Control::simplifyDocumentStrokes() {
+    clearSelectionEndText();
+
+    // Use the same tolerance as for new strokes, at 100% zoom
+    double tolerance = settings->getStrokeSimplificationTolerance() / zoom->getZoom100Value();
+
+    getCursor()->setCursorBusy(true);
+
+    auto undo = std::make_unique<SimplifyUndoAction>();
+
+    this->doc->lock();
+    for (size_t i = 0; i < this->doc->getPageCount(); i++) {
+        PageRef p = this->doc->getPage(i);
+        for (Layer* l: *p->getLayers()) {
+            for (Element* e: *l->getElements()) {
+                if (e->getType() != ELEMENT_STROKE) {
+                    continue;
+                }
+
+                auto* s = dynamic_cast<Stroke*>(e);
+                std::vector<Point> original = s->getPointVector();
+                if (s->simplify(tolerance)) {
+                    undo->addStroke(p, s, std::move(original));
+                }
+            }
+        }
+    }
+    this->doc->unlock();
+
+    if (!undo->isEmpty()) {
+        for (const PageRef& p: undo->getPages()) {
+            p->firePageChanged();
+        }
+        this->undoRedo->addUndoAction(std::move(undo));
+    }
+
+    getCursor()->setCursorBusy(false);
+}
+
 void Control::setViewPairedPages(bool enabled) {
     settings->setShowPairedPages(enabled);
     fireActionSelected(GROUP_PAIRED_PAGES, enabled ? ACTION_VIEW_PAIRED_PAGES : ACTION_NOT_SELECTED);
@@ -2849,6 +2903,8 @@ auto Control::getSidebar() -> Sidebar* { return this->sidebar; }
 
 auto Control::getSearchBar() -> SearchBar* { return this->searchBar; }
 
+auto Control::getSearchIndex() -> SearchIndex* { return this->searchIndex; }
+
 auto Control::getAudioController() -> AudioController* { return this->audioController; }
 
 auto Control::getPageTypes() -> PageTypeHandler* { return this->pageTypes; }
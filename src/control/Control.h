@@ -52,6 +52,7 @@ class PageTypeMenu;
 class BaseExportJob;
 class LayerController;
 class PluginController;
+class SearchIndex;
 
 class Control:
         public ActionHandler,
@@ -167,6 +168,11 @@ public:
     void paperTemplate();
     void paperFormat();
     void changePageBackgroundColor();
+
+    /**
+     * Removes redundant points of all strokes in the document, see Settings::getStrokeSimplificationTolerance()
+     */
+    void simplifyDocumentStrokes();
     void updateBackgroundSizeButton();
 
     void endDragDropToolbar();
@@ -241,6 +247,7 @@ public:
     XournalppCursor* getCursor();
     Sidebar* getSidebar();
     SearchBar* getSearchBar();
+    SearchIndex* getSearchIndex();
     AudioController* getAudioController();
     PageTypeHandler* getPageTypes();
     PageTypeMenu* getNewPageType();
@@ -344,6 +351,7 @@ private:
 
     Sidebar* sidebar = nullptr;
     SearchBar* searchBar = nullptr;
+    SearchIndex* searchIndex = nullptr;
 
     ToolHandler* toolHandler;
 
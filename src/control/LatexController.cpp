@@ -20,6 +20,11 @@
 #include "i18n.h"
 #include "pixbuf-utils.h"
 
+/**
+ * Delay after the last keystroke, until the LaTeX command is started
+ */
+constexpr guint LATEX_UPDATE_DELAY_MS = 300;
+
 LatexController::LatexController(Control* control):
         control(control),
         settings(control->getSettings()->latexSettings),
@@ -30,7 +35,13 @@ LatexController::LatexController(Control* control):
     Util::ensureFolderExists(this->texTmpDir);
 }
 
-LatexController::~LatexController() { this->control = nullptr; }
+LatexController::~LatexController() {
+    if (this->updateTimeout) {
+        g_source_remove(this->updateTimeout);
+        this->updateTimeout = 0;
+    }
+    this->control = nullptr;
+}
 
 /**
  * Find the tex executable, return false if not found
@@ -128,6 +139,10 @@ auto LatexController::showTexEditDialog() -> string {
 
     this->dlg.show(GTK_WINDOW(control->getWindow()->getWindow()), isNewFormula);
     g_signal_handler_disconnect(dlg.getTextBuffer(), signalHandler);
+    if (this->updateTimeout) {
+        g_source_remove(this->updateTimeout);
+        this->updateTimeout = 0;
+    }
 
     string result = this->dlg.getFinalTex();
     // If the user cancelled, there is no change in the latex string.
@@ -140,10 +155,25 @@ void LatexController::triggerImageUpdate(const string& texString) {
         return;
     }
 
-    this->setUpdating(true);
     this->lastPreviewedTex = texString;
     const std::string texContents = LatexGenerator::templateSub(
             texString, this->latexTemplate, this->control->getToolHandler()->getTool(TOOL_TEXT).getColor());
+    this->renderCachePath = generator.getCachedPdfPath(texContents);
+
+    if (fs::is_regular_file(this->renderCachePath)) {
+        // Rendered before, no need to run the LaTeX command
+        std::error_code ec;
+        fs::last_write_time(this->renderCachePath, fs::file_time_type::clock::now(), ec);
+        this->isValidTex = true;
+        this->temporaryRender = this->loadRendered(texString, this->renderCachePath);
+        if (this->temporaryRender != nullptr) {
+            this->dlg.setTempRender(this->temporaryRender->getPdf());
+        }
+        this->setUpdating(false);
+        return;
+    }
+
+    this->setUpdating(true);
     auto result = generator.asyncRun(this->texTmpDir, texContents);
     if (auto* err = std::get_if<LatexGenerator::GenError>(&result)) {
         this->setUpdating(false);
@@ -159,10 +189,33 @@ void LatexController::triggerImageUpdate(const string& texString) {
  * through 'self' because signal handlers cannot directly access non-static
  * methods and non-static fields such as 'dlg' so we need to wrap all the dlg
  * method inside small methods in 'self'. To improve performance, we render the
- * text asynchronously.
+ * text asynchronously, and only after the user stopped typing.
  */
 void LatexController::handleTexChanged(GtkTextBuffer* buffer, LatexController* self) {
+    if (self->updateTimeout) {
+        g_source_remove(self->updateTimeout);
+        self->updateTimeout = 0;
+    }
+
+    const string texString = self->dlg.getBufferContents();
+    const std::string texContents = LatexGenerator::templateSub(
+            texString, self->latexTemplate, self->control->getToolHandler()->getTool(TOOL_TEXT).getColor());
+    if (fs::is_regular_file(self->generator.getCachedPdfPath(texContents))) {
+        self->triggerImageUpdate(texString);
+        return;
+    }
+
+    // The preview does not match the text until the update is done
+    gtk_widget_set_sensitive(self->dlg.get("texokbutton"), false);
+    self->updateTimeout =
+            g_timeout_add(LATEX_UPDATE_DELAY_MS, reinterpret_cast<GSourceFunc>(updateTimeoutCallback), self);
+}
+
+auto LatexController::updateTimeoutCallback(LatexController* self) -> bool {
+    self->updateTimeout = 0;
     self->triggerImageUpdate(self->dlg.getBufferContents());
+
+    return false;
 }
 
 void LatexController::onPdfRenderComplete(GObject* procObj, GAsyncResult* res, LatexController* self) {
@@ -187,7 +240,16 @@ void LatexController::onPdfRenderComplete(GObject* procObj, GAsyncResult* res, L
         g_error_free(err);
     } else {
         self->isValidTex = true;
-        self->temporaryRender = self->loadRendered(currentTex);
+
+        // Keep the PDF, the same formula is not compiled again
+        fs::path pdfPath = self->texTmpDir / "tex.pdf";
+        std::error_code ec;
+        fs::copy_file(pdfPath, self->renderCachePath, fs::copy_options::overwrite_existing, ec);
+        if (ec) {
+            g_warning("latex: could not cache %s: %s", pdfPath.u8string().c_str(), ec.message().c_str());
+        }
+
+        self->temporaryRender = self->loadRendered(self->lastPreviewedTex, pdfPath);
         if (self->temporaryRender != nullptr) {
             self->dlg.setTempRender(self->temporaryRender->getPdf());
         }
@@ -232,12 +294,11 @@ void LatexController::deleteOldImage() {
     }
 }
 
-auto LatexController::loadRendered(string renderedTex) -> std::unique_ptr<TexImage> {
+auto LatexController::loadRendered(string renderedTex, const fs::path& pdfPath) -> std::unique_ptr<TexImage> {
     if (!this->isValidTex) {
         return nullptr;
     }
 
-    fs::path pdfPath = texTmpDir / "tex.pdf";
     auto contents = Util::readString(pdfPath, true);
     if (!contents) {
         return nullptr;
@@ -302,6 +363,9 @@ void LatexController::run() {
     this->findSelectedTexElement();
     const string newTex = this->showTexEditDialog();
 
+    // Every formula previewed while typing was cached
+    LatexGenerator::pruneCache();
+
     if (this->initialTex != newTex) {
         g_assert(this->isValidTex);
         this->insertTexImage();
@@ -94,10 +94,16 @@ private:
 
     /**
      * Signal handler, updates the rendered image when the text in the editor
-     * changes.
+     * changes. Formulas which are not cached yet are compiled after a short
+     * delay, so not every keystroke starts the LaTeX command.
      */
     static void handleTexChanged(GtkTextBuffer* buffer, LatexController* self);
 
+    /**
+     * Called when the user stopped typing, see handleTexChanged
+     */
+    static bool updateTimeoutCallback(LatexController* self);
+
     /**
      * Updates the display once the PDF file is generated.
      *
@@ -111,7 +117,7 @@ private:
     /**
      * Load the preview PDF from disk and create a TexImage object.
      */
-    std::unique_ptr<TexImage> loadRendered(string renderedTex);
+    std::unique_ptr<TexImage> loadRendered(string renderedTex, const fs::path& pdfPath);
 
     /**
      * Insert the generated preview TexImage into the current page.
@@ -153,6 +159,16 @@ private:
      */
     bool isUpdating = false;
 
+    /**
+     * Cache file of the formula which is currently being generated
+     */
+    fs::path renderCachePath;
+
+    /**
+     * Pending delayed preview update, see handleTexChanged
+     */
+    guint updateTimeout = 0;
+
     /**
      * Whether the current TeX string is valid.
      */
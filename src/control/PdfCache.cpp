@@ -129,3 +129,20 @@ void PdfCache::render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoo
 
     g_mutex_unlock(&this->renderMutex);
 }
+
+void PdfCache::renderPreview(cairo_t* cr, const XojPdfPageSPtr& popplerPage) {
+    g_mutex_lock(&this->renderMutex);
+
+    PdfCacheEntry* cacheResult = lookup(popplerPage);
+    if (cacheResult != nullptr) {
+        cairo_save(cr);
+        cairo_scale(cr, 1.0 / cacheResult->zoom, 1.0 / cacheResult->zoom);
+        cairo_set_source_surface(cr, cacheResult->rendered, 0, 0);
+        cairo_paint(cr);
+        cairo_restore(cr);
+    } else {
+        popplerPage->render(cr, false);
+    }
+
+    g_mutex_unlock(&this->renderMutex);
+}
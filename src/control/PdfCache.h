@@ -35,6 +35,12 @@ private:
 
 public:
     void render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom);
+
+    /**
+     * Draws the cached rendering of the page in any resolution, or renders the page directly into cr
+     * without caching it. Does not change the zoom of the cache.
+     */
+    void renderPreview(cairo_t* cr, const XojPdfPageSPtr& popplerPage);
     void clearCache();
 
 public:
@@ -6,7 +6,9 @@
 #include "model/Text.h"
 #include "view/TextView.h"
 
-SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf) {
+#include "SearchIndex.h"
+
+SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf, SearchIndex* index): index(index) {
     this->page = page;
     this->pdf = std::move(pdf);
 }
@@ -29,13 +31,7 @@ void SearchControl::paint(cairo_t* cr, GdkRectangle* rect, double zoom, const Gd
     }
 }
 
-auto SearchControl::search(string text, int* occures, double* top) -> bool {
-    freeSearchResults();
-
-    if (text.empty()) {
-        return true;
-    }
-
+void SearchControl::searchPage(string& text) {
     if (this->pdf) {
         this->results = this->pdf->findText(text);
     }
@@ -55,9 +51,23 @@ auto SearchControl::search(string text, int* occures, double* top) -> bool {
             }
         }
     }
+}
+
+auto SearchControl::search(string text, int* occures, double* top) -> bool {
+    freeSearchResults();
+
+    if (text.empty()) {
+        return true;
+    }
+
+    size_t matches = 0;
+    if (this->index == nullptr || !this->index->findOnPage(this->page, text, this->results, matches)) {
+        searchPage(text);
+        matches = this->results.size();
+    }
 
     if (occures) {
-        *occures = this->results.size();
+        *occures = matches;
     }
 
     if (top) {
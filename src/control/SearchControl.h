@@ -14,9 +14,11 @@
 #include "model/PageRef.h"
 #include "pdf/base/XojPdfPage.h"
 
+class SearchIndex;
+
 class SearchControl {
 public:
-    SearchControl(const PageRef& page, XojPdfPageSPtr pdf);
+    SearchControl(const PageRef& page, XojPdfPageSPtr pdf, SearchIndex* index);
     virtual ~SearchControl();
 
     bool search(string text, int* occures, double* top);
@@ -25,9 +27,15 @@ public:
 private:
     void freeSearchResults();
 
+    /**
+     * Searches the page without the index, if it was not indexed yet
+     */
+    void searchPage(string& text);
+
 private:
     PageRef page;
     XojPdfPageSPtr pdf;
+    SearchIndex* index;
 
     vector<XojPdfRectangle> results;
 };
@@ -0,0 +1,338 @@
+#include "SearchIndex.h"
+
+#include <algorithm>
+
+#include "control/Control.h"
+#include "control/jobs/SearchIndexJob.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/Text.h"
+#include "view/TextView.h"
+
+/**
+ * Time a SearchIndexJob may index pages, before it gives the Scheduler back to render jobs
+ */
+constexpr gint64 INDEX_TIME_SLICE_US = 50000;  // 50ms
+
+SearchIndex::SearchIndex(Control* control): control(control) { g_mutex_init(&this->indexMutex); }
+
+SearchIndex::~SearchIndex() {
+    this->control->getScheduler()->removeSearchIndex(this);
+    g_mutex_clear(&this->indexMutex);
+}
+
+void SearchIndex::setListener(SearchIndexListener* listener) { this->listener = listener; }
+
+void SearchIndex::foldText(const string& text, string& folded, vector<uint32_t>* charOffset) {
+    folded.clear();
+    folded.reserve(text.size());
+
+    for (const char* c = text.c_str(); *c != 0; c = g_utf8_next_char(c)) {
+        gunichar u = g_utf8_get_char(c);
+        // Line breaks of the PDF text layout should not prevent finding words over multiple lines
+        u = g_unichar_isspace(u) ? ' ' : g_unichar_tolower(u);
+
+        if (charOffset) {
+            charOffset->push_back(folded.size());
+        }
+
+        char buffer[6];
+        int len = g_unichar_to_utf8(u, buffer);
+        folded.append(buffer, len);
+    }
+}
+
+auto SearchIndex::createEntry(const string& text, const vector<XojPdfRectangle>& glyphs, int layerId)
+        -> IndexedText {
+    IndexedText entry;
+    entry.layerId = layerId;
+    foldText(text, entry.folded, &entry.charOffset);
+
+    entry.glyphs.reserve(glyphs.size());
+    for (const XojPdfRectangle& r: glyphs) {
+        entry.glyphs.push_back({static_cast<float>(r.x1), static_cast<float>(r.y1), static_cast<float>(r.x2),
+                                static_cast<float>(r.y2)});
+    }
+
+    return entry;
+}
+
+auto SearchIndex::findInEntry(const IndexedText& entry, const string& folded, vector<XojPdfRectangle>* results)
+        -> size_t {
+    size_t matches = 0;
+    if (folded.empty()) {
+        return matches;
+    }
+
+    for (size_t pos = entry.folded.find(folded); pos != string::npos; pos = entry.folded.find(folded, pos + 1)) {
+        matches++;
+
+        if (results == nullptr) {
+            continue;
+        }
+
+        // Map the byte range of the match to the characters
+        auto first = std::upper_bound(entry.charOffset.begin(), entry.charOffset.end(), pos) - 1;
+        auto last = std::upper_bound(entry.charOffset.begin(), entry.charOffset.end(), pos + folded.size() - 1) - 1;
+        size_t c1 = first - entry.charOffset.begin();
+        size_t c2 = std::min<size_t>(last - entry.charOffset.begin(), entry.glyphs.size() - 1);
+        if (c1 >= entry.glyphs.size()) {
+            continue;
+        }
+
+        // One rectangle per line the match is spanning
+        XojPdfRectangle current(entry.glyphs[c1].x1, entry.glyphs[c1].y1, entry.glyphs[c1].x2, entry.glyphs[c1].y2);
+        for (size_t c = c1 + 1; c <= c2; c++) {
+            const GlyphBox& g = entry.glyphs[c];
+            if (g.x2 <= g.x1 || g.y2 <= g.y1) {
+                // e.g. line breaks
+                continue;
+            }
+
+            bool sameLine = g.y1 < current.y2 && g.y2 > current.y1 && g.x1 >= current.x1;
+            if (sameLine) {
+                current.x1 = std::min<double>(current.x1, g.x1);
+                current.y1 = std::min<double>(current.y1, g.y1);
+                current.x2 = std::max<double>(current.x2, g.x2);
+                current.y2 = std::max<double>(current.y2, g.y2);
+            } else {
+                results->push_back(current);
+                current = XojPdfRectangle(g.x1, g.y1, g.x2, g.y2);
+            }
+        }
+        results->push_back(current);
+    }
+
+    return matches;
+}
+
+auto SearchIndex::findOnPage(const PageRef& page, const string& text, vector<XojPdfRectangle>& results,
+                             size_t& matches) -> bool {
+    string folded;
+    foldText(text, folded, nullptr);
+    matches = 0;
+
+    g_mutex_lock(&this->indexMutex);
+
+    auto it = this->pages.find(page);
+    bool indexed = it != this->pages.end();
+    if (indexed) {
+        for (const IndexedText& entry: it->second) {
+            if (entry.layerId > 0 && !page->isLayerVisible(entry.layerId)) {
+                continue;
+            }
+            matches += findInEntry(entry, folded, &results);
+        }
+    }
+
+    g_mutex_unlock(&this->indexMutex);
+
+    return indexed;
+}
+
+auto SearchIndex::search(const string& text, vector<int>& matches) -> bool {
+    string folded;
+    foldText(text, folded, nullptr);
+
+    Document* doc = this->control->getDocument();
+    doc->lock();
+    size_t count = doc->getPageCount();
+    vector<PageRef> docPages;
+    docPages.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        docPages.push_back(doc->getPage(i));
+    }
+    doc->unlock();
+
+    matches.assign(count, -1);
+    bool complete = true;
+
+    g_mutex_lock(&this->indexMutex);
+
+    for (size_t i = 0; i < count; i++) {
+        auto it = this->pages.find(docPages[i]);
+        if (it == this->pages.end()) {
+            complete = false;
+            continue;
+        }
+
+        size_t found = 0;
+        for (const IndexedText& entry: it->second) {
+            if (entry.layerId > 0 && !docPages[i]->isLayerVisible(entry.layerId)) {
+                continue;
+            }
+            found += findInEntry(entry, folded, nullptr);
+        }
+        matches[i] = found;
+    }
+
+    g_mutex_unlock(&this->indexMutex);
+
+    return complete;
+}
+
+auto SearchIndex::createPageEntry(const PageRef& page) -> PageEntry {
+    PageEntry entry;
+    Document* doc = this->control->getDocument();
+
+    if (page->getBackgroundType().isPdfPage()) {
+        XojPdfPageSPtr pdf = doc->getPdfPage(page->getPdfPageNr());
+        if (pdf) {
+            vector<XojPdfRectangle> glyphs;
+            string text = pdf->getTextLayout(glyphs);
+            entry.push_back(createEntry(text, glyphs, 0));
+        }
+    }
+
+    int layerId = 0;
+    for (Layer* l: *page->getLayers()) {
+        layerId++;
+
+        for (Element* e: *l->getElements()) {
+            if (e->getType() == ELEMENT_TEXT) {
+                Text* t = dynamic_cast<Text*>(e);
+                entry.push_back(createEntry(t->getText(), TextView::getCharacterBoxes(t), layerId));
+            }
+        }
+    }
+
+    return entry;
+}
+
+void SearchIndex::resyncUnlocked() {
+    Document* doc = this->control->getDocument();
+    size_t count = doc->getPageCount();
+
+    std::unordered_map<PageRef, PageEntry> current;
+    current.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        PageRef page = doc->getPage(i);
+
+        auto it = this->pages.find(page);
+        if (it != this->pages.end()) {
+            current.emplace(page, std::move(it->second));
+        } else if (std::find(this->pending.begin(), this->pending.end(), page) == this->pending.end()) {
+            this->pending.push_back(page);
+        }
+    }
+
+    // Removes the entries of deleted pages
+    this->pages = std::move(current);
+    this->resync = false;
+}
+
+void SearchIndex::indexPendingPages() {
+    gint64 start = g_get_monotonic_time();
+    Document* doc = this->control->getDocument();
+
+    while (g_get_monotonic_time() - start < INDEX_TIME_SLICE_US) {
+        doc->lock();
+        g_mutex_lock(&this->indexMutex);
+
+        if (this->resync) {
+            resyncUnlocked();
+        }
+
+        if (this->pending.empty()) {
+            g_mutex_unlock(&this->indexMutex);
+            doc->unlock();
+            return;
+        }
+
+        PageRef page = this->pending.front();
+        this->pending.pop_front();
+        g_mutex_unlock(&this->indexMutex);
+
+        if (doc->indexOf(page) == npos) {
+            // The page was deleted in the meantime
+            doc->unlock();
+            continue;
+        }
+
+        PageEntry entry = createPageEntry(page);
+        doc->unlock();
+
+        g_mutex_lock(&this->indexMutex);
+        this->pages[page] = std::move(entry);
+        g_mutex_unlock(&this->indexMutex);
+    }
+}
+
+void SearchIndex::indexJobFinished() {
+    this->jobScheduled = false;
+
+    g_mutex_lock(&this->indexMutex);
+    bool morePages = !this->pending.empty() || this->resync;
+    g_mutex_unlock(&this->indexMutex);
+
+    if (morePages) {
+        scheduleJob();
+    }
+
+    if (this->listener) {
+        this->listener->searchIndexUpdated();
+    }
+}
+
+void SearchIndex::scheduleJob() {
+    if (this->jobScheduled) {
+        return;
+    }
+    this->jobScheduled = true;
+
+    this->control->getScheduler()->addIndexSearch(this);
+}
+
+void SearchIndex::markDirty(const PageRef& page) {
+    if (!page) {
+        return;
+    }
+
+    g_mutex_lock(&this->indexMutex);
+    this->pages.erase(page);
+    if (std::find(this->pending.begin(), this->pending.end(), page) == this->pending.end()) {
+        this->pending.push_back(page);
+    }
+    g_mutex_unlock(&this->indexMutex);
+
+    scheduleJob();
+}
+
+void SearchIndex::documentChanged(DocumentChangeType type) {
+    if (type != DOCUMENT_CHANGE_CLEARED && type != DOCUMENT_CHANGE_COMPLETE) {
+        return;
+    }
+
+    g_mutex_lock(&this->indexMutex);
+    this->pages.clear();
+    this->pending.clear();
+    this->resync = true;
+    g_mutex_unlock(&this->indexMutex);
+
+    scheduleJob();
+}
+
+void SearchIndex::pageChanged(size_t page) {
+    // Called in the UI Thread, which is the only one modifying the page list
+    markDirty(this->control->getDocument()->getPage(page));
+}
+
+void SearchIndex::pageInserted(size_t page) {
+    g_mutex_lock(&this->indexMutex);
+    this->resync = true;
+    g_mutex_unlock(&this->indexMutex);
+
+    scheduleJob();
+}
+
+void SearchIndex::pageDeleted(size_t page) {
+    g_mutex_lock(&this->indexMutex);
+    this->resync = true;
+    g_mutex_unlock(&this->indexMutex);
+
+    scheduleJob();
+}
+
+void SearchIndex::undoRedoChanged() {}
+
+void SearchIndex::undoRedoPageChanged(PageRef page) { markDirty(page); }
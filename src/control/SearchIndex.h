@@ -0,0 +1,162 @@
+/*
+ * Xournal++
+ *
+ * Document wide text index, used to search PDF text and Text elements
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "model/DocumentListener.h"
+#include "model/PageRef.h"
+#include "pdf/base/XojPdfPage.h"
+#include "undo/UndoRedoHandler.h"
+
+#include "XournalType.h"
+
+class Control;
+
+class SearchIndexListener {
+public:
+    /**
+     * Called in the UI Thread each time new pages were added to the index
+     */
+    virtual void searchIndexUpdated() = 0;
+
+    virtual ~SearchIndexListener() = default;
+};
+
+/**
+ * The index is filled in the background by SearchIndexJob%s and updated incrementally
+ * each time a page is changed, so searching the whole document does not need to touch
+ * poppler or pango.
+ */
+class SearchIndex: public DocumentListener, public UndoRedoListener {
+public:
+    SearchIndex(Control* control);
+    virtual ~SearchIndex();
+
+public:
+    void setListener(SearchIndexListener* listener);
+
+    /**
+     * Searches the text on a single page
+     *
+     * @param results Filled with the rectangles to highlight
+     * @param matches Filled with the number of occurrences
+     * @return false if the page is not indexed yet, the caller has to search the page itself
+     */
+    bool findOnPage(const PageRef& page, const string& text, vector<XojPdfRectangle>& results, size_t& matches);
+
+    /**
+     * Searches the text on all pages of the document
+     *
+     * @param matches Filled with the number of occurrences per page, -1 if the page is not indexed yet
+     * @return true if the whole document is indexed
+     */
+    bool search(const string& text, vector<int>& matches);
+
+    /**
+     * Indexes the pending pages for a short amount of time, called by SearchIndexJob
+     */
+    void indexPendingPages();
+
+    /**
+     * Called in the UI Thread after a SearchIndexJob has finished
+     */
+    void indexJobFinished();
+
+public:
+    // DocumentListener interface
+    void documentChanged(DocumentChangeType type) override;
+    void pageChanged(size_t page) override;
+    void pageInserted(size_t page) override;
+    void pageDeleted(size_t page) override;
+
+public:
+    // UndoRedoListener interface
+    void undoRedoChanged() override;
+    void undoRedoPageChanged(PageRef page) override;
+
+private:
+    struct GlyphBox {
+        float x1;
+        float y1;
+        float x2;
+        float y2;
+    };
+
+    /**
+     * A text run (the PDF text of a page, or a Text element), lowercased
+     */
+    struct IndexedText {
+        string folded;
+
+        /**
+         * Byte offset of each character in folded
+         */
+        vector<uint32_t> charOffset;
+
+        /**
+         * Bounding box of each character
+         */
+        vector<GlyphBox> glyphs;
+
+        /**
+         * Layer ID of the Text element, 0 for the PDF background
+         */
+        int layerId = 0;
+    };
+
+    using PageEntry = vector<IndexedText>;
+
+    static void foldText(const string& text, string& folded, vector<uint32_t>* charOffset);
+    static IndexedText createEntry(const string& text, const vector<XojPdfRectangle>& glyphs, int layerId);
+    static size_t findInEntry(const IndexedText& entry, const string& folded, vector<XojPdfRectangle>* results);
+
+    PageEntry createPageEntry(const PageRef& page);
+
+    /**
+     * Synchronizes the index with the pages of the document, needs the document lock
+     */
+    void resyncUnlocked();
+
+    void markDirty(const PageRef& page);
+    void scheduleJob();
+
+private:
+    Control* control = nullptr;
+    SearchIndexListener* listener = nullptr;
+
+    /**
+     * Protects pages, pending and resync
+     */
+    GMutex indexMutex{};
+
+    std::unordered_map<PageRef, PageEntry> pages;
+
+    /**
+     * Pages which need to be (re)indexed
+     */
+    std::deque<PageRef> pending;
+
+    /**
+     * The page list of the document has changed, compare the index with the document
+     */
+    bool resync = false;
+
+    /**
+     * A SearchIndexJob is scheduled or running, only accessed in the UI Thread
+     */
+    bool jobScheduled = false;
+};
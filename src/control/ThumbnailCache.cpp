@@ -0,0 +1,338 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "model/Document.h"
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/TexImage.h"
+#include "model/Text.h"
+#include "view/DocumentView.h"
+
+#include "PathUtil.h"
+#include "StringUtils.h"
+
+/**
+ * Size of the first page preview, which is read by the thumbnailer
+ */
+constexpr int DOCUMENT_PREVIEW_SIZE = 256;
+
+/**
+ * The least recently used thumbnails are removed, if the cache is larger
+ */
+constexpr uintmax_t CACHE_SIZE_LIMIT = 64 * 1024 * 1024;
+
+/**
+ * The cache is also pruned while running, after this many bytes were stored
+ */
+constexpr uintmax_t PRUNE_INTERVAL = CACHE_SIZE_LIMIT / 8;
+
+/**
+ * Protects cachedFolders and storedSincePrune, thumbnails are stored by the preview and the save jobs
+ */
+static std::mutex storeMutex;
+
+/**
+ * The file names in each document folder, the folder is only listed the first time a thumbnail is stored into it
+ */
+static std::map<fs::path, std::set<string>> cachedFolders;
+
+static uintmax_t storedSincePrune = 0;
+
+ThumbnailCache::ThumbnailCache() = default;
+
+ThumbnailCache::~ThumbnailCache() = default;
+
+static void hashValue(GChecksum* checksum, const void* data, size_t len) {
+    g_checksum_update(checksum, static_cast<const guchar*>(data), len);
+}
+
+static void hashDouble(GChecksum* checksum, double d) { hashValue(checksum, &d, sizeof(d)); }
+
+static void hashInt(GChecksum* checksum, int i) { hashValue(checksum, &i, sizeof(i)); }
+
+static void hashString(GChecksum* checksum, const string& s) {
+    // Including the terminating 0, so two strings cannot be merged
+    hashValue(checksum, s.c_str(), s.size() + 1);
+}
+
+static void hashSurface(GChecksum* checksum, cairo_surface_t* surface) {
+    if (surface == nullptr || cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return;
+    }
+
+    cairo_surface_flush(surface);
+    int height = cairo_image_surface_get_height(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    unsigned char* data = cairo_image_surface_get_data(surface);
+    if (data) {
+        hashValue(checksum, data, static_cast<size_t>(height) * stride);
+    }
+}
+
+auto ThumbnailCache::hashPage(Document* doc, const PageRef& page) -> string {
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA1);
+
+    hashDouble(checksum, page->getWidth());
+    hashDouble(checksum, page->getHeight());
+
+    PageType bg = page->getBackgroundType();
+    hashInt(checksum, static_cast<int>(bg.format));
+    hashString(checksum, bg.config);
+    Color bgColor = page->getBackgroundColor();
+    hashValue(checksum, &bgColor, sizeof(bgColor));
+    if (bg.isPdfPage()) {
+        hashString(checksum, doc->getPdfFilepath().u8string());
+        hashInt(checksum, static_cast<int>(page->getPdfPageNr()));
+    } else if (bg.isImagePage()) {
+        hashString(checksum, page->getBackgroundImage().getFilepath().u8string());
+    }
+
+    for (Layer* l: *page->getLayers()) {
+        if (!l->isVisible()) {
+            continue;
+        }
+        hashInt(checksum, l->getElements()->size());
+
+        for (Element* e: *l->getElements()) {
+            hashInt(checksum, e->getType());
+            Color color = e->getColor();
+            hashValue(checksum, &color, sizeof(color));
+            hashDouble(checksum, e->getX());
+            hashDouble(checksum, e->getY());
+
+            if (e->getType() == ELEMENT_STROKE) {
+                auto* s = dynamic_cast<Stroke*>(e);
+                hashDouble(checksum, s->getWidth());
+                hashInt(checksum, s->getToolType());
+                hashInt(checksum, s->getFill());
+
+                const double* dashes = nullptr;
+                int dashCount = 0;
+                if (s->getLineStyle().getDashes(dashes, dashCount)) {
+                    hashValue(checksum, dashes, dashCount * sizeof(double));
+                }
+
+                const std::vector<Point>& points = s->getPointVector();
+                hashValue(checksum, points.data(), points.size() * sizeof(Point));
+            } else if (e->getType() == ELEMENT_TEXT) {
+                auto* t = dynamic_cast<Text*>(e);
+                hashString(checksum, t->getText());
+                hashString(checksum, t->getFontName());
+                hashDouble(checksum, t->getFontSize());
+            } else if (e->getType() == ELEMENT_IMAGE) {
+                auto* img = dynamic_cast<Image*>(e);
+                hashDouble(checksum, img->getElementWidth());
+                hashDouble(checksum, img->getElementHeight());
+                hashSurface(checksum, img->getImage());
+            } else if (e->getType() == ELEMENT_TEXIMAGE) {
+                auto* img = dynamic_cast<TexImage*>(e);
+                hashDouble(checksum, img->getElementWidth());
+                hashDouble(checksum, img->getElementHeight());
+                hashString(checksum, img->getBinaryData());
+            }
+        }
+    }
+
+    string hash = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+
+    return hash;
+}
+
+auto ThumbnailCache::getPageFile(Document* doc, const PageRef& page, int width, int height) -> fs::path {
+    fs::path filepath = doc->getFilepath();
+    if (filepath.empty()) {
+        filepath = doc->getPdfFilepath();
+    }
+
+    size_t index = doc->indexOf(page);
+    if (filepath.empty() || index == npos || width <= 0 || height <= 0) {
+        return fs::path{};
+    }
+
+    fs::path file = Util::getThumbnailCacheFolder(filepath);
+    file /= FS(FORMAT_STR("{1}-{2}x{3}-{4}.png") % index % width % height % hashPage(doc, page));
+    return file;
+}
+
+auto ThumbnailCache::load(const fs::path& file) -> cairo_surface_t* {
+    std::error_code ec;
+    if (!fs::is_regular_file(file, ec)) {
+        return nullptr;
+    }
+
+    cairo_surface_t* surface = cairo_image_surface_create_from_png(file.u8string().c_str());
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(surface);
+        return nullptr;
+    }
+
+    // Used for the least recently used pruning
+    fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+
+    return surface;
+}
+
+void ThumbnailCache::store(const fs::path& file, cairo_surface_t* surface) {
+    std::error_code ec;
+    fs::path folder = file.parent_path();
+    fs::create_directories(folder, ec);
+    string name = file.filename().u8string();
+
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+
+        auto it = cachedFolders.find(folder);
+        if (it == cachedFolders.end()) {
+            it = cachedFolders.emplace(folder, std::set<string>{}).first;
+            for (auto const& entry: fs::directory_iterator(folder, ec)) {
+                it->second.insert(entry.path().filename().u8string());
+            }
+        }
+        std::set<string>& files = it->second;
+
+        // The file name starts with "<page>-<width>x<height>-", remove the outdated thumbnails of this page
+        size_t hashPos = name.rfind('-');
+        if (hashPos != string::npos) {
+            string prefix = name.substr(0, hashPos + 1);
+            for (auto f = files.lower_bound(prefix); f != files.end() && StringUtils::startsWith(*f, prefix);) {
+                if (*f == name) {
+                    ++f;
+                    continue;
+                }
+                fs::remove(folder / *f, ec);
+                f = files.erase(f);
+            }
+        }
+    }
+
+    // Write to a temporary file first, another instance may read the cache at the same time
+    fs::path tmp = file;
+    tmp += ".tmp";
+    if (cairo_surface_write_to_png(surface, tmp.u8string().c_str()) != CAIRO_STATUS_SUCCESS) {
+        fs::remove(tmp, ec);
+        return;
+    }
+
+    uintmax_t size = fs::file_size(tmp, ec);
+    if (ec) {
+        size = 0;
+    }
+    fs::rename(tmp, file, ec);
+    if (ec) {
+        g_warning("Could not store thumbnail %s: %s", file.u8string().c_str(), ec.message().c_str());
+        fs::remove(tmp, ec);
+        return;
+    }
+
+    bool pruneNow = false;
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        cachedFolders[folder].insert(name);
+
+        storedSincePrune += size;
+        if (storedSincePrune > PRUNE_INTERVAL) {
+            storedSincePrune = 0;
+            pruneNow = true;
+        }
+    }
+
+    if (pruneNow) {
+        prune();
+    }
+}
+
+void ThumbnailCache::storeDocumentPreview(Document* doc, const fs::path& filepath) {
+    if (doc->getPageCount() == 0) {
+        return;
+    }
+
+    cairo_surface_t* preview = renderPage(doc, doc->getPage(0), DOCUMENT_PREVIEW_SIZE);
+    store(Util::getThumbnailCacheFolder(filepath) / "preview.png", preview);
+    cairo_surface_destroy(preview);
+}
+
+auto ThumbnailCache::renderPage(Document* doc, const PageRef& page, int size) -> cairo_surface_t* {
+    double width = page->getWidth();
+    double height = page->getHeight();
+
+    double zoom = 1;
+
+    if (width < height) {
+        zoom = size / height;
+    } else {
+        zoom = size / width;
+    }
+    width *= zoom;
+    height *= zoom;
+
+    cairo_surface_t* crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+
+    cairo_t* cr = cairo_create(crBuffer);
+    cairo_scale(cr, zoom, zoom);
+
+    if (page->getBackgroundType().isPdfPage()) {
+        int pgNo = page->getPdfPageNr();
+        XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
+        if (popplerPage) {
+            popplerPage->render(cr, false);
+        }
+    }
+
+    DocumentView view;
+    view.drawPage(page, cr, true);
+    cairo_destroy(cr);
+
+    return crBuffer;
+}
+
+void ThumbnailCache::prune() {
+    {
+        // The folders are listed again after pruning
+        std::lock_guard<std::mutex> lock(storeMutex);
+        cachedFolders.clear();
+    }
+
+    std::error_code ec;
+    fs::path root = Util::getCacheSubfolder("thumbnails");
+
+    std::vector<std::pair<fs::file_time_type, fs::path>> files;
+    uintmax_t size = 0;
+    for (auto const& entry: fs::recursive_directory_iterator(root, ec)) {
+        if (!entry.is_regular_file(ec)) {
+            continue;
+        }
+        size += entry.file_size(ec);
+        files.emplace_back(entry.last_write_time(ec), entry.path());
+    }
+
+    if (size <= CACHE_SIZE_LIMIT) {
+        return;
+    }
+
+    std::sort(files.begin(), files.end());
+    for (auto const& f: files) {
+        if (size <= CACHE_SIZE_LIMIT) {
+            break;
+        }
+
+        uintmax_t fileSize = fs::file_size(f.second, ec);
+        if (!ec && fs::remove(f.second, ec)) {
+            size -= fileSize;
+        }
+    }
+
+    // Remove the folders of documents without thumbnails
+    for (auto const& entry: fs::directory_iterator(root, ec)) {
+        if (entry.is_directory(ec) && fs::is_empty(entry.path(), ec)) {
+            fs::remove(entry.path(), ec);
+        }
+    }
+}
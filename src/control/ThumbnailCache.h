@@ -0,0 +1,70 @@
+/*
+ * Xournal++
+ *
+ * On disk cache of page thumbnails, shared by the sidebar and the thumbnailer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+
+#include <cairo.h>
+
+#include "model/PageRef.h"
+
+#include "XournalType.h"
+#include "filesystem.h"
+
+class Document;
+
+/**
+ * The thumbnails are stored in the user cache folder, in one folder per document (see
+ * Util::getThumbnailCacheFolder). The file name contains the page index, the size of the
+ * thumbnail and a hash of the page contents, so a modified page never matches an old entry.
+ */
+class ThumbnailCache {
+private:
+    ThumbnailCache();
+    virtual ~ThumbnailCache();
+
+public:
+    /**
+     * Returns the cache file of a page thumbnail, or an empty path if the document has no file
+     * (needs the document lock)
+     */
+    static fs::path getPageFile(Document* doc, const PageRef& page, int width, int height);
+
+    /**
+     * Loads a thumbnail, nullptr if it is not cached
+     */
+    static cairo_surface_t* load(const fs::path& file);
+
+    /**
+     * Stores a thumbnail and removes the older thumbnails of the same page and size
+     */
+    static void store(const fs::path& file, cairo_surface_t* surface);
+
+    /**
+     * Renders the first page of the saved document for the thumbnailer (needs the document lock)
+     */
+    static void storeDocumentPreview(Document* doc, const fs::path& filepath);
+
+    /**
+     * Renders a page, so its longer side is size pixels long (needs the document lock)
+     */
+    static cairo_surface_t* renderPage(Document* doc, const PageRef& page, int size);
+
+    /**
+     * Removes the least recently used thumbnails, if the cache is larger than its limit.
+     * Called on exit, and by store() after a part of the limit was stored.
+     */
+    static void prune();
+
+private:
+    static string hashPage(Document* doc, const PageRef& page);
+};
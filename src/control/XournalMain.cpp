@@ -9,6 +9,7 @@
 #include <libintl.h>
 
 #include "control/jobs/ImageExport.h"
+#include "control/jobs/JobTrace.h"
 #include "control/jobs/ProgressListener.h"
 #include "gui/GladeSearchpath.h"
 #include "gui/MainWindow.h"
@@ -18,6 +19,7 @@
 #include "undo/EmergencySaveRestore.h"
 #include "xojfile/LoadHandler.h"
 
+#include "BatchConversion.h"
 #include "Control.h"
 #include "Stacktrace.h"
 #include "StringUtils.h"
@@ -363,11 +365,16 @@ struct XournalMainPrivate {
         g_strfreev(optFilename);
         g_free(pdfFilename);
         g_free(imgFilename);
+        g_free(traceFilename);
+        g_free(batchFilename);
     }
 
     gchar** optFilename{};
     gchar* pdfFilename{};
     gchar* imgFilename{};
+    gchar* traceFilename{};
+    gchar* batchFilename{};
+    int batchJobs = 0;
     gboolean showVersion = false;
     int openAtPageNumber = 0;  // when no --page is used, the document opens at the page specified in the metadata file
     gchar* exportRange{};
@@ -494,6 +501,10 @@ void on_open_files(GApplication*, gpointer, gint, gchar*, XMPtr) {
 }
 
 void on_startup(GApplication* application, XMPtr app_data) {
+    if (app_data->traceFilename) {
+        JobTrace::enable(Util::fromGFilename(app_data->traceFilename, false));
+    }
+
     initLocalisation();
     ensure_input_model_compatibility();
     MigrateResult migrateResult = migrateSettings();
@@ -582,6 +593,11 @@ auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gi
         return 0;
     }
 
+    if (app_data->batchFilename) {
+        BatchConversion batch(app_data->exportRange, app_data->exportPngDpi, app_data->exportPngWidth,
+                              app_data->exportPngHeight, app_data->exportNoBackground, app_data->presentationMode);
+        return batch.run(Util::fromGFilename(app_data->batchFilename, false), app_data->batchJobs);
+    }
     if (app_data->pdfFilename && app_data->optFilename && *app_data->optFilename) {
         return exportPdf(*app_data->optFilename, app_data->pdfFilename, app_data->exportRange,
                          app_data->exportNoBackground, app_data->presentationMode);
@@ -597,6 +613,7 @@ void on_shutdown(GApplication*, XMPtr app_data) {
     app_data->control->saveSettings();
     app_data->win->getXournal()->clearSelection();
     app_data->control->getScheduler()->stop();
+    JobTrace::writeFile();
     ToolbarColorNames::getInstance().save();
 }
 
@@ -619,6 +636,11 @@ auto XournalMain::run(int argc, char** argv) -> int {
                                        "<input>", nullptr},
                           GOptionEntry{"version", 0, 0, G_OPTION_ARG_NONE, &app_data.showVersion,
                                        _("Get version of xournalpp"), nullptr},
+                          GOptionEntry{"trace-jobs", 0, 0, G_OPTION_ARG_FILENAME, &app_data.traceFilename,
+                                       _("Record the background jobs and write them to FILE on exit\n"
+                                         "                                 The file can be opened in "
+                                         "chrome://tracing or https://ui.perfetto.dev"),
+                                       "FILE"},
                           GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     g_application_add_main_option_entries(G_APPLICATION(app), options.data());
 
@@ -633,6 +655,15 @@ auto XournalMain::run(int argc, char** argv) -> int {
                            "                                 Guess the output format from the extension of IMGFILE\n"
                            "                                 Supported formats: .png, .svg"),
                          "IMGFILE"},
+            GOptionEntry{"batch", 0, 0, G_OPTION_ARG_FILENAME, &app_data.batchFilename,
+                         _("Convert all files listed in MANIFEST, \"-\" reads the list from stdin\n"
+                           "                                 One conversion per line: <input><TAB><output>\n"
+                           "                                 The status of each file is written to stdout as JSON"),
+                         "MANIFEST"},
+            GOptionEntry{"batch-jobs", 0, 0, G_OPTION_ARG_INT, &app_data.batchJobs,
+                         _("Count of files converted in parallel, default is one per processor\n"
+                           "                                 No effect without --batch"),
+                         "N"},
             GOptionEntry{"export-no-background", 0, 0, G_OPTION_ARG_NONE, &app_data.exportNoBackground,
                          _("Export without background\n"
                            "                                 The exported file has transparent or white background,\n"
@@ -645,7 +676,8 @@ auto XournalMain::run(int argc, char** argv) -> int {
                          0},
             GOptionEntry{"export-range", 0, 0, G_OPTION_ARG_STRING, &app_data.exportRange,
                          _("Only export the pages specified by RANGE (e.g. \"2-3,5,7-\")\n"
-                           "                                 No effect without -p/--create-pdf or -i/--create-img"),
+                           "                                 No effect without -p/--create-pdf, -i/--create-img\n"
+                           "                                 or --batch"),
                          nullptr},
             GOptionEntry{"export-png-dpi", 0, 0, G_OPTION_ARG_INT, &app_data.exportPngDpi,
                          _("Set DPI for PNG exports. Default is 300\n"
@@ -19,6 +19,9 @@ void AutosaveJob::afterRun() {
 
 void AutosaveJob::run() {
     SaveHandler handler;
+    // The autosave file is only temporary, it should interrupt the user as short as possible
+    handler.setCompressionLevel(Z_BEST_SPEED);
+    handler.setSharePayloads(control->getSettings()->isShareImageData());
 
     control->getUndoRedoHandler()->documentAutosaved();
 
@@ -124,6 +124,7 @@ void CustomExportJob::run() {
         Document* doc = this->control->getDocument();
 
         XojExportHandler h;
+        h.setCompressionLevel(this->control->getSettings()->getSaveCompressionLevel());
         doc->lock();
         h.prepareSave(doc);
         h.saveTo(filepath, this->control);
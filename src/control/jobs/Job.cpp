@@ -35,6 +35,8 @@ void Job::execute() { this->run(); }
 
 auto Job::getSource() -> void* { return nullptr; }
 
+auto Job::getTracePage() -> int { return -1; }
+
 auto Job::callAfterCallback(Job* job) -> bool {
     job->afterRun();
 
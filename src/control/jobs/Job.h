@@ -16,7 +16,7 @@
 
 #include "XournalType.h"
 
-enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE };
+enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE, JOB_TYPE_SEARCH_INDEX };
 
 class Job {
 public:
@@ -52,6 +52,12 @@ public:
 
     virtual void* getSource();
 
+    /**
+     * @return The index of the page the Job worked on, for JobTrace. -1 if the Job is not about a page,
+     * only valid after it was executed.
+     */
+    virtual int getTracePage();
+
 protected:
     /**
      * override this method
@@ -80,4 +86,12 @@ private:
 
     int refCount = 1;
     GMutex refMutex{};
+
+    /**
+     * Set by the Scheduler, for JobTrace
+     */
+    gint64 queueTime = 0;
+    int priority = -1;
+
+    friend class Scheduler;
 };
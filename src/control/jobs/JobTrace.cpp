@@ -0,0 +1,153 @@
+#include "JobTrace.h"
+
+#include <fstream>
+#include <utility>
+
+#include "i18n.h"
+
+/**
+ * Number of recorded events, older ones are overwritten
+ */
+constexpr size_t TRACE_BUFFER_SIZE = 65536;
+
+std::atomic<bool> JobTrace::enabled{false};
+std::vector<JobTrace::Event> JobTrace::events;
+
+static GMutex traceMutex;
+static std::vector<std::pair<int, string>> threadNames;
+static fs::path traceFile;
+
+static size_t nextEvent = 0;
+static bool bufferFull = false;
+
+static std::atomic<int> lastThreadId{0};
+
+JobTrace::JobTrace() = default;
+
+JobTrace::~JobTrace() = default;
+
+void JobTrace::enable(const fs::path& file) {
+    g_mutex_lock(&traceMutex);
+    traceFile = file;
+    events.assign(TRACE_BUFFER_SIZE, Event{});
+    nextEvent = 0;
+    bufferFull = false;
+    g_mutex_unlock(&traceMutex);
+
+    setThreadName("UI");
+    enabled = true;
+}
+
+auto JobTrace::getThreadId() -> int {
+    thread_local int id = ++lastThreadId;
+    return id;
+}
+
+void JobTrace::setThreadName(const string& name) {
+    int id = getThreadId();
+
+    g_mutex_lock(&traceMutex);
+    threadNames.emplace_back(id, name);
+    g_mutex_unlock(&traceMutex);
+}
+
+void JobTrace::addEvent(const char* name, gint64 start, gint64 end, int page, int priority, gint64 queued) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    Event e;
+    e.name = name;
+    e.start = start;
+    e.duration = end - start;
+    e.queued = queued;
+    e.thread = getThreadId();
+    e.page = page;
+    e.priority = priority;
+
+    g_mutex_lock(&traceMutex);
+    events[nextEvent] = e;
+    nextEvent++;
+    if (nextEvent == TRACE_BUFFER_SIZE) {
+        nextEvent = 0;
+        bufferFull = true;
+    }
+    g_mutex_unlock(&traceMutex);
+}
+
+static auto priorityName(int priority) -> const char* {
+    static const char* names[] = {"urgent", "high", "low", "none"};
+    if (priority < 0 || priority >= static_cast<int>(G_N_ELEMENTS(names))) {
+        return "unknown";
+    }
+    return names[priority];
+}
+
+void JobTrace::writeFile() {
+    if (!isEnabled()) {
+        return;
+    }
+
+    g_mutex_lock(&traceMutex);
+
+    std::ofstream out(traceFile);
+    out << "{\"traceEvents\":[\n";
+
+    bool first = true;
+    for (auto const& t: threadNames) {
+        gchar* escaped = g_strescape(t.second.c_str(), nullptr);
+        out << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << t.first
+            << R"(,"args":{"name":")" << escaped << "\"}}";
+        g_free(escaped);
+        first = false;
+    }
+
+    size_t count = bufferFull ? TRACE_BUFFER_SIZE : nextEvent;
+    size_t begin = bufferFull ? nextEvent : 0;
+    for (size_t i = 0; i < count; i++) {
+        const Event& e = events[(begin + i) % TRACE_BUFFER_SIZE];
+
+        // Jobs are recorded by the Scheduler with their priority, the other events are spans inside of a job
+        bool job = e.priority >= 0;
+        out << (first ? "" : ",\n") << R"({"name":")" << e.name << R"(","cat":")" << (job ? "job" : "render")
+            << R"(","ph":"X","pid":1,"tid":)" << e.thread << ",\"ts\":" << e.start << ",\"dur\":" << e.duration
+            << ",\"args\":{";
+
+        bool firstArg = true;
+        if (e.page >= 0) {
+            out << "\"page\":" << e.page;
+            firstArg = false;
+        }
+        if (job) {
+            out << (firstArg ? "" : ",") << R"("priority":")" << priorityName(e.priority) << "\"";
+            if (e.queued > 0) {
+                out << ",\"queue_us\":" << (e.start - e.queued);
+            }
+        }
+        out << "}}";
+        first = false;
+    }
+
+    out << "\n]}\n";
+    out.close();
+
+    if (out.fail()) {
+        g_warning("Could not write the job trace to %s", traceFile.u8string().c_str());
+    } else {
+        g_message("%s", FC(_F("Job trace written to {1}") % traceFile.u8string()));
+    }
+
+    g_mutex_unlock(&traceMutex);
+}
+
+TraceSpan::TraceSpan(const char* name, int page): name(name), page(page) {
+    if (JobTrace::isEnabled()) {
+        this->start = g_get_monotonic_time();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (this->start != 0) {
+        JobTrace::addEvent(this->name, this->start, g_get_monotonic_time(), this->page);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Xournal++
+ *
+ * Records the background jobs, to find out why rendering is slow
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+#include "XournalType.h"
+#include "filesystem.h"
+
+/**
+ * Tracing is enabled with --trace-jobs=FILE. The events are kept in a ring buffer and written
+ * to FILE on exit, in the Chrome trace event format (chrome://tracing, https://ui.perfetto.dev).
+ * If tracing is disabled, recording an event only reads an atomic flag.
+ */
+class JobTrace {
+private:
+    JobTrace();
+    virtual ~JobTrace();
+
+public:
+    /**
+     * Starts recording, should be called from the UI thread
+     */
+    static void enable(const fs::path& file);
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Names the calling thread in the trace
+     */
+    static void setThreadName(const string& name);
+
+    /**
+     * Records a finished span, the times are from g_get_monotonic_time()
+     *
+     * @param name A string literal
+     * @param page The page index, or -1
+     * @param priority The JobPriority of a job, or -1
+     * @param queued The time the job was added to the queue, or 0
+     */
+    static void addEvent(const char* name, gint64 start, gint64 end, int page = -1, int priority = -1,
+                         gint64 queued = 0);
+
+    /**
+     * Writes the recorded events to the file passed to enable()
+     */
+    static void writeFile();
+
+private:
+    struct Event {
+        const char* name = nullptr;
+        gint64 start = 0;
+        gint64 duration = 0;
+        gint64 queued = 0;
+        int thread = 0;
+        int page = -1;
+        int priority = -1;
+    };
+
+    static int getThreadId();
+
+    static std::atomic<bool> enabled;
+
+    /**
+     * Ring buffer of the recorded events
+     */
+    static std::vector<Event> events;
+};
+
+/**
+ * Records the time until the end of the scope, if tracing is enabled
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, int page = -1);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    void operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    int page;
+    gint64 start = 0;
+};
@@ -1,6 +1,7 @@
 #include "PreviewJob.h"
 
 #include "control/Control.h"
+#include "control/ThumbnailCache.h"
 #include "gui/Shadow.h"
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"
 #include "gui/sidebar/previews/base/SidebarPreviewBaseEntry.h"
@@ -9,12 +10,16 @@
 #include "view/DocumentView.h"
 #include "view/PdfView.h"
 
+#include "JobTrace.h"
+
 PreviewJob::PreviewJob(SidebarPreviewBaseEntry* sidebar): sidebarPreview(sidebar) {}
 
 PreviewJob::~PreviewJob() { this->sidebarPreview = nullptr; }
 
 auto PreviewJob::getSource() -> void* { return this->sidebarPreview; }
 
+auto PreviewJob::getTracePage() -> int { return this->pageIndex; }
+
 auto PreviewJob::getType() -> JobType { return JOB_TYPE_PREVIEW; }
 
 void PreviewJob::initGraphics() {
@@ -84,26 +89,56 @@ void PreviewJob::drawPage(int layer) {
 }
 
 void PreviewJob::run() {
-    initGraphics();
-    drawBorder();
-
     Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
     doc->lock();
 
     PreviewRenderType type = this->sidebarPreview->getRenderType();
     int layer = -100;  // all layer
+    if (JobTrace::isEnabled()) {
+        this->pageIndex = static_cast<int>(doc->indexOf(this->sidebarPreview->page));
+    }
+
+    fs::path cacheFile;
+    if (RENDER_TYPE_PAGE_PREVIEW == type) {
+        TraceSpan span("Thumbnail cache lookup", this->pageIndex);
+        GtkAllocation alloc;
+        gtk_widget_get_allocation(this->sidebarPreview->widget, &alloc);
+        cacheFile = ThumbnailCache::getPageFile(doc, this->sidebarPreview->page, alloc.width, alloc.height);
+
+        if (!cacheFile.empty() && (crBuffer = ThumbnailCache::load(cacheFile)) != nullptr) {
+            doc->unlock();
+            finishPaint();
+            return;
+        }
+    }
+
+    initGraphics();
+    drawBorder();
 
     if (RENDER_TYPE_PAGE_LAYER == type) {
         layer = (dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview))->getLayer();
     }
 
     if (this->sidebarPreview->page->getBackgroundType().isPdfPage()) {
+        if (!doc->getPdfPage(this->sidebarPreview->page->getPdfPageNr())) {
+            // Do not cache a thumbnail without its background
+            cacheFile.clear();
+        }
+        TraceSpan span("PDF background", this->pageIndex);
         drawBackgroundPdf(doc);
     }
 
-    drawPage(layer);
+    {
+        TraceSpan span("Layers", this->pageIndex);
+        drawPage(layer);
+    }
 
     doc->unlock();
 
+    if (!cacheFile.empty()) {
+        TraceSpan span("Thumbnail cache store", this->pageIndex);
+        ThumbnailCache::store(cacheFile, crBuffer);
+    }
+
     finishPaint();
 }
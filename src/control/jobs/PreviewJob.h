@@ -35,6 +35,8 @@ protected:
 public:
     virtual void* getSource();
 
+    virtual int getTracePage();
+
     virtual void run();
 
     virtual JobType getType();
@@ -66,4 +68,9 @@ private:
      * Sidebar preview
      */
     SidebarPreviewBaseEntry* sidebarPreview = nullptr;
+
+    /**
+     * Only set if JobTrace is enabled
+     */
+    int pageIndex = -1;
 };
@@ -1,5 +1,6 @@
 #include "RenderJob.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "control/Control.h"
@@ -7,17 +8,124 @@
 #include "gui/PageView.h"
 #include "gui/XournalView.h"
 #include "model/Document.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
 #include "view/DocumentView.h"
 #include "view/PdfView.h"
 
+#include "JobTrace.h"
+
 #include "Rectangle.h"
 #include "Util.h"
 
+/**
+ * Resolution of the draft of a page, relative to the complete rendering
+ */
+constexpr double DRAFT_SCALE = 0.25;
+
+/**
+ * Changed rectangles are rendered as one, if at most this part of their union is unchanged: a few unchanged
+ * pixels are drawn faster than the elements in the overlap of two passes
+ */
+constexpr double MAX_MERGE_WASTE = 0.25;
+
+/**
+ * Regions with more rectangles are rendered as their extents
+ */
+constexpr int MAX_REGION_RECTANGLES = 64;
+
+static auto area(cairo_rectangle_int_t const& r) -> double { return static_cast<double>(r.width) * r.height; }
+
+static auto unite(cairo_rectangle_int_t const& a, cairo_rectangle_int_t const& b) -> cairo_rectangle_int_t {
+    int x1 = std::min(a.x, b.x);
+    int y1 = std::min(a.y, b.y);
+    int x2 = std::max(a.x + a.width, b.x + b.width);
+    int y2 = std::max(a.y + a.height, b.y + b.height);
+    return {x1, y1, x2 - x1, y2 - y1};
+}
+
+/**
+ * Splits the region into the rectangles to render, neighbouring rectangles are merged
+ */
+static auto coalesceRegion(const cairo_region_t* region) -> vector<Rectangle<double>> {
+    vector<cairo_rectangle_int_t> rects;
+    int count = cairo_region_num_rectangles(region);
+    if (count > MAX_REGION_RECTANGLES) {
+        rects.resize(1);
+        cairo_region_get_extents(region, &rects[0]);
+    } else {
+        rects.resize(count);
+        for (int i = 0; i < count; i++) {
+            cairo_region_get_rectangle(region, i, &rects[i]);
+        }
+    }
+
+    // The changed area within each rectangle, the rectangles of a region do not overlap
+    vector<double> changed;
+    changed.reserve(rects.size());
+    for (cairo_rectangle_int_t const& r: rects) {
+        changed.push_back(area(r));
+    }
+
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (size_t i = 0; i < rects.size(); i++) {
+            for (size_t j = i + 1; j < rects.size(); j++) {
+                cairo_rectangle_int_t u = unite(rects[i], rects[j]);
+                if (area(u) - changed[i] - changed[j] <= MAX_MERGE_WASTE * area(u)) {
+                    rects[i] = u;
+                    changed[i] += changed[j];
+                    rects.erase(rects.begin() + j);
+                    changed.erase(changed.begin() + j);
+                    merged = true;
+                    j = i;
+                }
+            }
+        }
+    }
+
+    vector<Rectangle<double>> result;
+    result.reserve(rects.size());
+    for (cairo_rectangle_int_t const& r: rects) {
+        result.emplace_back(r.x, r.y, r.width, r.height);
+    }
+    return result;
+}
+
+/**
+ * A buffer large enough to render each of the rectangles, used for all of them
+ */
+static auto createScratchBuffer(vector<Rectangle<double>> const& rects, double zoom) -> cairo_surface_t* {
+    int width = 1;
+    int height = 1;
+    for (Rectangle<double> const& rect: rects) {
+        width = std::max(width, int(std::lround(rect.width * zoom)));
+        height = std::max(height, int(std::lround(rect.height * zoom)));
+    }
+    return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+}
+
+/**
+ * Starts drawing a rectangle of the page at (x, y) into the scratch buffer, the area of the rectangle is cleared
+ */
+static auto createScratchContext(cairo_surface_t* scratch, int x, int y, int width, int height) -> cairo_t* {
+    cairo_t* cr = cairo_create(scratch);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_clip(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    cairo_translate(cr, -x, -y);
+    return cr;
+}
+
 RenderJob::RenderJob(XojPageView* view): view(view) {}
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
-void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
+auto RenderJob::getTracePage() -> int { return this->pageIndex; }
+
+void RenderJob::rerenderRectangle(Rectangle<double> const& rect, cairo_surface_t* scratch) {
     double zoom = view->xournal->getZoom();
     Document* doc = view->xournal->getDocument();
     doc->lock();
@@ -30,9 +138,7 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
     auto width = int(std::lround(rect.width * zoom));
     auto height = int(std::lround(rect.height * zoom));
 
-    cairo_surface_t* rectBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crRect = cairo_create(rectBuffer);
-    cairo_translate(crRect, -x, -y);
+    cairo_t* crRect = createScratchContext(scratch, x, y, width, height);
     cairo_scale(crRect, zoom, zoom);
 
     DocumentView v;
@@ -42,20 +148,35 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
 
     bool backgroundVisible = view->page->isLayerVisible(0);
     if (backgroundVisible && view->page->getBackgroundType().isPdfPage()) {
+        TraceSpan span("PDF background", this->pageIndex);
         int pgNo = view->page->getPdfPageNr();
         XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
         PdfCache* cache = view->xournal->getCache();
         PdfView::drawPage(cache, popplerPage, crRect, zoom, pageWidth, pageHeight);
     }
 
-    doc->lock();
-    v.drawPage(view->page, crRect, false);
-    doc->unlock();
+    {
+        TraceSpan span("Layers", this->pageIndex);
+        doc->lock();
+        v.drawPage(view->page, crRect, false);
+        doc->unlock();
+    }
 
     cairo_destroy(crRect);
 
+    blitRectangle(scratch, x, y, width, height);
+}
+
+void RenderJob::blitRectangle(cairo_surface_t* rectBuffer, int x, int y, int width, int height) {
+    TraceSpan blitSpan("Blit", this->pageIndex);
     g_mutex_lock(&view->drawingMutex);
 
+    if (view->crBuffer == nullptr || view->crBufferDraft) {
+        // Freed or replaced by a draft in the meantime, the page is rendered completely again
+        g_mutex_unlock(&view->drawingMutex);
+        return;
+    }
+
     cairo_t* crPageBuffer = cairo_create(view->crBuffer);
 
     cairo_set_operator(crPageBuffer, CAIRO_OPERATOR_SOURCE);
@@ -65,26 +186,303 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
 
     cairo_destroy(crPageBuffer);
 
-    cairo_surface_destroy(rectBuffer);
+    // The other zoom levels do not contain the change
+    view->deleteZoomLevels();
 
     g_mutex_unlock(&view->drawingMutex);
 }
 
+auto RenderJob::isMarkAudioStroke() -> bool {
+    Control* control = view->getXournal()->getControl();
+    return control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT;
+}
+
+void RenderJob::drawLayerBuffer(cairo_surface_t* buffer, double zoom, size_t first, size_t last, bool background,
+                                Rectangle<double> const* rect) {
+    cairo_t* cr = cairo_create(buffer);
+
+    DocumentView v;
+    v.setMarkAudioStroke(isMarkAudioStroke());
+
+    if (rect) {
+        cairo_rectangle(cr, std::lround(rect->x * zoom), std::lround(rect->y * zoom), std::lround(rect->width * zoom),
+                        std::lround(rect->height * zoom));
+        cairo_clip(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+        cairo_paint(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+        v.limitArea(rect->x, rect->y, rect->width, rect->height);
+    }
+    cairo_scale(cr, zoom, zoom);
+
+    PageRef page = view->page;
+    if (background && page->isLayerVisible(0) && page->getBackgroundType().isPdfPage()) {
+        TraceSpan span("PDF background", this->pageIndex);
+        XojPdfPageSPtr popplerPage = view->xournal->getDocument()->getPdfPage(page->getPdfPageNr());
+        PdfView::drawPage(view->xournal->getCache(), popplerPage, cr, zoom, page->getWidth(), page->getHeight());
+    }
+
+    v.drawPageLayers(page, cr, first, last, background);
+
+    cairo_destroy(cr);
+}
+
+void RenderJob::drawComposite(cairo_t* cr, double zoom, cairo_surface_t* below, size_t first, size_t last,
+                              cairo_surface_t* above, Rectangle<double> const* rect) {
+    cairo_set_source_surface(cr, below, 0, 0);
+    cairo_paint(cr);
+
+    cairo_save(cr);
+    cairo_scale(cr, zoom, zoom);
+
+    DocumentView v;
+    v.setMarkAudioStroke(isMarkAudioStroke());
+    if (rect) {
+        v.limitArea(rect->x, rect->y, rect->width, rect->height);
+    }
+    v.drawPageLayers(view->page, cr, first, last, false);
+
+    cairo_restore(cr);
+
+    if (above) {
+        cairo_set_source_surface(cr, above, 0, 0);
+        cairo_paint(cr);
+    }
+}
+
+void RenderJob::renderDraft(double zoom) {
+    TraceSpan span("Draft", this->pageIndex);
+
+    Document* doc = view->xournal->getDocument();
+    PageRef page = view->page;
+
+    double draftZoom = zoom * DRAFT_SCALE;
+    int width = std::max(1, int(std::lround(view->getDisplayWidth() * DRAFT_SCALE)));
+    int height = std::max(1, int(std::lround(view->getDisplayHeight() * DRAFT_SCALE)));
+
+    cairo_surface_t* buffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(buffer);
+    cairo_scale(cr, draftZoom, draftZoom);
+
+    doc->lock();
+
+    if (page->isLayerVisible(0) && page->getBackgroundType().isPdfPage()) {
+        XojPdfPageSPtr popplerPage = doc->getPdfPage(page->getPdfPageNr());
+        PdfCache* cache = view->xournal->getCache();
+        if (popplerPage && cache) {
+            // Uses the cached rendering of any zoom, or renders only the few pixels of the draft
+            cairo_set_source_rgb(cr, 1., 1., 1.);
+            cairo_paint(cr);
+            cache->renderPreview(cr, popplerPage);
+        } else {
+            PdfView::drawPage(cache, popplerPage, cr, draftZoom, page->getWidth(), page->getHeight());
+        }
+    }
+
+    DocumentView v;
+    v.setDraftMode(true);
+    v.setMarkAudioStroke(isMarkAudioStroke());
+    v.drawPage(page, cr, false);
+
+    doc->unlock();
+
+    cairo_destroy(cr);
+
+    g_mutex_lock(&view->drawingMutex);
+    if (view->crBuffer == nullptr) {
+        view->crBuffer = buffer;
+        view->crBufferDraft = true;
+        view->draftRerenderScheduled = false;
+    } else {
+        cairo_surface_destroy(buffer);
+    }
+    g_mutex_unlock(&view->drawingMutex);
+}
+
+void RenderJob::rerenderLayers(bool complete, bool otherLayers, vector<Rectangle<double>> const& rects,
+                               double zoom) {
+    Document* doc = view->xournal->getDocument();
+    PageRef page = view->page;
+
+    int dispWidth = view->getDisplayWidth();
+    int dispHeight = view->getDisplayHeight();
+
+    doc->lock();
+
+    // The same layer as XojPage::getSelectedLayer(), also if the background is selected
+    vector<Layer*>* layers = page->getLayers();
+    size_t layerCount = layers->size();
+    size_t selected = std::min<size_t>(std::max(page->getSelectedLayerId(), 1) - 1, layerCount);
+    size_t aboveFirst = std::min(selected + 1, layerCount);
+
+    // Highlighter strokes are multiplied with the content below them, so the layers above
+    // can only be rendered into a separate buffer if they contain none
+    bool aboveCached = true;
+    bool aboveVisible = false;
+    for (size_t i = aboveFirst; i < layerCount && aboveCached; i++) {
+        Layer* l = (*layers)[i];
+        if (!page->isLayerVisible(l)) {
+            continue;
+        }
+        aboveVisible = true;
+
+        for (Element* e: *l->getElements()) {
+            if (e->getType() == ELEMENT_STROKE &&
+                dynamic_cast<Stroke*>(e)->getToolType() == STROKE_TOOL_HIGHLIGHTER) {
+                aboveCached = false;
+                break;
+            }
+        }
+    }
+    size_t compositeLast = aboveCached ? aboveFirst : layerCount;
+
+    string key = std::to_string(zoom) + " " + std::to_string(dispWidth) + "x" + std::to_string(dispHeight) + " " +
+                 std::to_string(selected) + (aboveCached ? " cached " : " direct ") +
+                 (isMarkAudioStroke() ? "audio " : "");
+    for (size_t i = 0; i <= layerCount; i++) {
+        key += page->isLayerVisible(static_cast<int>(i)) ? '1' : '0';
+    }
+
+    // Only this job accesses the layer buffers while they are taken from the view
+    g_mutex_lock(&view->drawingMutex);
+    cairo_surface_t* below = view->belowLayersBuffer;
+    cairo_surface_t* above = view->aboveLayersBuffer;
+    view->belowLayersBuffer = nullptr;
+    view->aboveLayersBuffer = nullptr;
+    bool valid = below && view->crBuffer && key == view->layerBuffersKey;
+    g_mutex_unlock(&view->drawingMutex);
+
+    if (complete || !valid) {
+        if (below) {
+            cairo_surface_destroy(below);
+        }
+        if (above) {
+            cairo_surface_destroy(above);
+            above = nullptr;
+        }
+
+        below = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, dispWidth, dispHeight);
+        {
+            TraceSpan span("Layers below", this->pageIndex);
+            drawLayerBuffer(below, zoom, 0, selected, true, nullptr);
+        }
+        if (aboveCached && aboveVisible) {
+            TraceSpan span("Layers above", this->pageIndex);
+            above = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, dispWidth, dispHeight);
+            drawLayerBuffer(above, zoom, aboveFirst, layerCount, false, nullptr);
+        }
+
+        cairo_surface_t* crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, dispWidth, dispHeight);
+        cairo_t* cr = cairo_create(crBuffer);
+        {
+            TraceSpan span("Layers", this->pageIndex);
+            drawComposite(cr, zoom, below, selected, compositeLast, above, nullptr);
+        }
+        cairo_destroy(cr);
+
+        TraceSpan span("Blit", this->pageIndex);
+        g_mutex_lock(&view->drawingMutex);
+        view->replaceBuffer(crBuffer);
+        g_mutex_unlock(&view->drawingMutex);
+    } else {
+        cairo_surface_t* scratch = createScratchBuffer(rects, zoom);
+        for (Rectangle<double> const& rect: rects) {
+            if (otherLayers) {
+                TraceSpan span("Layer buffers", this->pageIndex);
+                drawLayerBuffer(below, zoom, 0, selected, true, &rect);
+                if (above) {
+                    drawLayerBuffer(above, zoom, aboveFirst, layerCount, false, &rect);
+                }
+            }
+
+            auto x = int(std::lround(rect.x * zoom));
+            auto y = int(std::lround(rect.y * zoom));
+            auto width = int(std::lround(rect.width * zoom));
+            auto height = int(std::lround(rect.height * zoom));
+
+            cairo_t* crRect = createScratchContext(scratch, x, y, width, height);
+            {
+                TraceSpan span("Layers", this->pageIndex);
+                drawComposite(crRect, zoom, below, selected, compositeLast, above, &rect);
+            }
+            cairo_destroy(crRect);
+
+            blitRectangle(scratch, x, y, width, height);
+        }
+        cairo_surface_destroy(scratch);
+    }
+
+    doc->unlock();
+
+    g_mutex_lock(&view->drawingMutex);
+    // The view buffer was freed in the meantime, so are the layer buffers
+    if (view->crBuffer == nullptr) {
+        cairo_surface_destroy(below);
+        if (above) {
+            cairo_surface_destroy(above);
+        }
+    } else {
+        view->belowLayersBuffer = below;
+        view->aboveLayersBuffer = above;
+        view->layerBuffersKey = key;
+    }
+    g_mutex_unlock(&view->drawingMutex);
+}
+
 void RenderJob::run() {
     double zoom = this->view->xournal->getZoom();
 
     g_mutex_lock(&this->view->repaintRectMutex);
 
     bool rerenderComplete = this->view->rerenderComplete;
-    auto rerenderRects = std::move(this->view->rerenderRects);
+    bool rerenderOtherLayers = this->view->rerenderOtherLayers;
+    cairo_region_t* rerenderRegion = this->view->rerenderRegion;
+    this->view->rerenderRegion = cairo_region_create();
 
     this->view->rerenderComplete = false;
+    this->view->rerenderOtherLayers = false;
 
     g_mutex_unlock(&this->view->repaintRectMutex);
 
+    vector<Rectangle<double>> rerenderRects = coalesceRegion(rerenderRegion);
+    cairo_region_destroy(rerenderRegion);
+
     int dpiScaleFactor = this->view->xournal->getDpiScaleFactor();
 
-    if (rerenderComplete || dpiScaleFactor > 1) {
+    if (JobTrace::isEnabled()) {
+        Document* doc = this->view->xournal->getDocument();
+        doc->lock();
+        this->pageIndex = static_cast<int>(doc->indexOf(this->view->page));
+        doc->unlock();
+    }
+
+    Settings* settings = this->view->xournal->getControl()->getSettings();
+
+    if (rerenderComplete && settings->isProgressiveRendering()) {
+        g_mutex_lock(&this->view->drawingMutex);
+        bool hasBuffer = this->view->crBuffer != nullptr;
+        g_mutex_unlock(&this->view->drawingMutex);
+
+        if (!hasBuffer) {
+            // The complete rendering is scheduled when the draft is painted
+            renderDraft(zoom);
+            repaintWidget(this->view->getXournal()->getWidget());
+            return;
+        }
+    }
+
+    // Like the rectangles, the layer buffers do not support DPI scaling
+    bool useLayerBuffers = dpiScaleFactor == 1 && settings->isLayerCacheEnabled();
+    if (!useLayerBuffers) {
+        g_mutex_lock(&this->view->drawingMutex);
+        this->view->deleteLayerBuffers();
+        g_mutex_unlock(&this->view->drawingMutex);
+    }
+
+    if (useLayerBuffers) {
+        rerenderLayers(rerenderComplete, rerenderOtherLayers, rerenderRects, zoom);
+    } else if (rerenderComplete || dpiScaleFactor > 1) {
         Document* doc = this->view->xournal->getDocument();
 
         int dispWidth = this->view->getDisplayWidth();
@@ -115,25 +513,42 @@ void RenderJob::run() {
 
         bool backgroundVisible = this->view->page->isLayerVisible(0);
         if (backgroundVisible) {
+            TraceSpan span("PDF background", this->pageIndex);
             PdfView::drawPage(this->view->xournal->getCache(), popplerPage, cr2, zoom, width, height);
         }
-        localView.drawPage(this->view->page, cr2, false);
+        {
+            TraceSpan span("Layers", this->pageIndex);
+            localView.drawPage(this->view->page, cr2, false);
+        }
 
         cairo_destroy(cr2);
 
+        {
+            TraceSpan span("Blit", this->pageIndex);
+            g_mutex_lock(&this->view->drawingMutex);
+
+            this->view->replaceBuffer(crBuffer);
+
+            g_mutex_unlock(&this->view->drawingMutex);
+        }
+        doc->unlock();
+    } else if (!rerenderRects.empty()) {
         g_mutex_lock(&this->view->drawingMutex);
+        bool hasBuffer = this->view->crBuffer != nullptr && !this->view->crBufferDraft;
+        g_mutex_unlock(&this->view->drawingMutex);
 
-        if (this->view->crBuffer) {
-            cairo_surface_destroy(this->view->crBuffer);
+        if (!hasBuffer) {
+            // The rectangles are in the coordinates of the complete rendering, which is scheduled
+            // when the draft is painted and redraws them as well
+            repaintWidget(this->view->getXournal()->getWidget());
+            return;
         }
-        this->view->crBuffer = crBuffer;
 
-        g_mutex_unlock(&this->view->drawingMutex);
-        doc->unlock();
-    } else {
+        cairo_surface_t* scratch = createScratchBuffer(rerenderRects, zoom);
         for (Rectangle<double> const& rect: rerenderRects) {
-            rerenderRectangle(rect);
+            rerenderRectangle(rect, scratch);
         }
+        cairo_surface_destroy(scratch);
     }
 
     // Schedule a repaint of the widget
@@ -34,6 +34,8 @@ public:
 
     void* getSource();
 
+    int getTracePage();
+
     void run();
 
 private:
@@ -42,8 +44,51 @@ private:
      */
     static void repaintWidget(GtkWidget* widget);
 
-    void rerenderRectangle(Rectangle<double> const& rect);
+    /**
+     * Renders the rectangle into the scratch buffer and copies it into the buffer of the view
+     */
+    void rerenderRectangle(Rectangle<double> const& rect, cairo_surface_t* scratch);
+
+    /**
+     * Copies the rectangle (x, y, width, height) of the page, rendered at the top left of rectBuffer,
+     * into the buffer of the view
+     */
+    void blitRectangle(cairo_surface_t* rectBuffer, int x, int y, int width, int height);
+
+    /**
+     * Renders the page from the layer buffers of the view, the buffers are (re)drawn as needed
+     *
+     * @param complete Redraw everything, not only the rectangles
+     * @param otherLayers The rectangles also contain changes outside of the selected layer
+     */
+    void rerenderLayers(bool complete, bool otherLayers, vector<Rectangle<double>> const& rects, double zoom);
+
+    /**
+     * Draws the background (if requested) and the layers [first, last) into a layer buffer
+     *
+     * @param rect Only this area is cleared and redrawn, the whole buffer if nullptr
+     */
+    void drawLayerBuffer(cairo_surface_t* buffer, double zoom, size_t first, size_t last, bool background,
+                         Rectangle<double> const* rect);
+
+    /**
+     * Draws the layer buffers and the layers [first, last) in between into cr, which is in pixel coordinates
+     */
+    void drawComposite(cairo_t* cr, double zoom, cairo_surface_t* below, size_t first, size_t last,
+                       cairo_surface_t* above, Rectangle<double> const* rect);
+
+    bool isMarkAudioStroke();
+
+    /**
+     * Renders a low resolution draft of the page, which is shown until the page is rendered completely
+     */
+    void renderDraft(double zoom);
 
 private:
     XojPageView* view;
+
+    /**
+     * Only set if JobTrace is enabled
+     */
+    int pageIndex = -1;
 };
@@ -3,8 +3,8 @@
 #include <config.h>
 
 #include "control/Control.h"
+#include "control/ThumbnailCache.h"
 #include "control/xojfile/SaveHandler.h"
-#include "view/DocumentView.h"
 
 #include "PathUtil.h"
 #include "XojMsgBox.h"
@@ -40,37 +40,7 @@ void SaveJob::updatePreview(Control* control) {
     doc->lock();
 
     if (doc->getPageCount() > 0) {
-        PageRef page = doc->getPage(0);
-
-        double width = page->getWidth();
-        double height = page->getHeight();
-
-        double zoom = 1;
-
-        if (width < height) {
-            zoom = previewSize / height;
-        } else {
-            zoom = previewSize / width;
-        }
-        width *= zoom;
-        height *= zoom;
-
-        cairo_surface_t* crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-
-        cairo_t* cr = cairo_create(crBuffer);
-        cairo_scale(cr, zoom, zoom);
-
-        if (page->getBackgroundType().isPdfPage()) {
-            int pgNo = page->getPdfPageNr();
-            XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
-            if (popplerPage) {
-                popplerPage->render(cr, false);
-            }
-        }
-
-        DocumentView view;
-        view.drawPage(page, cr, true);
-        cairo_destroy(cr);
+        cairo_surface_t* crBuffer = ThumbnailCache::renderPage(doc, doc->getPage(0), previewSize);
         doc->setPreview(crBuffer);
         cairo_surface_destroy(crBuffer);
     } else {
@@ -84,6 +54,8 @@ auto SaveJob::save() -> bool {
     updatePreview(control);
     Document* doc = this->control->getDocument();
     SaveHandler h;
+    h.setCompressionLevel(this->control->getSettings()->getSaveCompressionLevel());
+    h.setSharePayloads(this->control->getSettings()->isShareImageData());
 
     doc->lock();
     h.prepareSave(doc);
@@ -105,6 +77,10 @@ auto SaveJob::save() -> bool {
     doc->lock();
     h.saveTo(target, this->control);
     doc->setFilepath(target);
+    if (h.getErrorMessage().empty()) {
+        // Written after the document, so the thumbnailer knows the preview is up to date
+        ThumbnailCache::storeDocumentPreview(doc, target);
+    }
     doc->unlock();
 
     if (!h.getErrorMessage().empty()) {
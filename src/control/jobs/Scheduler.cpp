@@ -4,6 +4,8 @@
 
 #include <config-debug.h>
 
+#include "JobTrace.h"
+
 #ifdef DEBUG_SHEDULER
 #define SDEBUG g_message
 #else
@@ -80,6 +82,10 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
     g_mutex_lock(&this->jobQueueMutex);
 
     job->ref();
+    job->priority = priority;
+    if (JobTrace::isEnabled()) {
+        job->queueTime = g_get_monotonic_time();
+    }
     g_queue_push_tail(this->jobQueue[priority], job);
     g_cond_broadcast(&this->jobQueueCond);
 
@@ -189,7 +195,25 @@ auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
     return false;
 }
 
+static auto getJobName(JobType type) -> const char* {
+    switch (type) {
+        case JOB_TYPE_BLOCKING:
+            return "BlockingJob";
+        case JOB_TYPE_PREVIEW:
+            return "PreviewJob";
+        case JOB_TYPE_RENDER:
+            return "RenderJob";
+        case JOB_TYPE_AUTOSAVE:
+            return "AutosaveJob";
+        case JOB_TYPE_SEARCH_INDEX:
+            return "SearchIndexJob";
+    }
+    return "Job";
+}
+
 auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
+    JobTrace::setThreadName(scheduler->name);
+
     while (scheduler->threadRunning) {
         // lock the whole scheduler
         g_mutex_lock(&scheduler->schedulerMutex);
@@ -244,8 +268,15 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
 
         g_mutex_lock(&scheduler->jobRunningMutex);
 
+        gint64 start = JobTrace::isEnabled() ? g_get_monotonic_time() : 0;
+
         job->execute();
 
+        if (start != 0) {
+            JobTrace::addEvent(getJobName(job->getType()), start, g_get_monotonic_time(), job->getTracePage(),
+                               job->priority, job->queueTime);
+        }
+
         job->unref();
         g_mutex_unlock(&scheduler->jobRunningMutex);
 
@@ -0,0 +1,19 @@
+#include "SearchIndexJob.h"
+
+#include "control/SearchIndex.h"
+
+SearchIndexJob::SearchIndexJob(SearchIndex* index): index(index) {}
+
+SearchIndexJob::~SearchIndexJob() { this->index = nullptr; }
+
+auto SearchIndexJob::getType() -> JobType { return JOB_TYPE_SEARCH_INDEX; }
+
+auto SearchIndexJob::getSource() -> void* { return this->index; }
+
+void SearchIndexJob::run() {
+    this->index->indexPendingPages();
+
+    callAfterRun();
+}
+
+void SearchIndexJob::afterRun() { this->index->indexJobFinished(); }
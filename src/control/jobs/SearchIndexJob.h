@@ -0,0 +1,39 @@
+/*
+ * Xournal++
+ *
+ * A job which fills the search index in the background
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Job.h"
+#include "XournalType.h"
+
+class SearchIndex;
+
+class SearchIndexJob: public Job {
+public:
+    SearchIndexJob(SearchIndex* index);
+
+protected:
+    virtual ~SearchIndexJob();
+
+public:
+    virtual void run();
+    void afterRun();
+
+    virtual JobType getType();
+
+    void* getSource();
+
+private:
+    SearchIndex* index = nullptr;
+};
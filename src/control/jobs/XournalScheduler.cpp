@@ -1,7 +1,12 @@
 #include "XournalScheduler.h"
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 #include "PreviewJob.h"
 #include "RenderJob.h"
+#include "SearchIndexJob.h"
 
 XournalScheduler::XournalScheduler()
 
@@ -17,6 +22,10 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
 
 void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
 
+void XournalScheduler::removeSearchIndex(SearchIndex* index) {
+    removeSource(index, JOB_TYPE_SEARCH_INDEX, JOB_PRIORITY_NONE);
+}
+
 void XournalScheduler::removeAllJobs() {
     g_mutex_lock(&this->jobQueueMutex);
 
@@ -106,3 +115,73 @@ void XournalScheduler::addRerenderPage(XojPageView* view) {
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
 }
+
+void XournalScheduler::rankRenderJobs(const std::function<double(XojPageView*)>& distance, double maxDistance) {
+    vector<void*> removed = rankJobs(
+            JOB_TYPE_RENDER, JOB_PRIORITY_URGENT,
+            [&](void* source) { return distance(static_cast<XojPageView*>(source)); }, maxDistance);
+
+    // Not while holding the queue lock, painting a page takes the drawing lock first and then the queue lock
+    for (void* source: removed) {
+        static_cast<XojPageView*>(source)->deleteViewBuffer();
+    }
+}
+
+void XournalScheduler::rankPreviewJobs(const std::function<double(SidebarPreviewBaseEntry*)>& distance,
+                                        double maxDistance) {
+    vector<void*> removed = rankJobs(
+            JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH,
+            [&](void* source) { return distance(static_cast<SidebarPreviewBaseEntry*>(source)); }, maxDistance);
+
+    for (void* source: removed) {
+        static_cast<SidebarPreviewBaseEntry*>(source)->deleteBuffer();
+    }
+}
+
+auto XournalScheduler::rankJobs(JobType type, JobPriority priority, const std::function<double(void*)>& distance,
+                                double maxDistance) -> vector<void*> {
+    vector<void*> removed;
+    vector<std::pair<double, Job*>> ranked;
+
+    g_mutex_lock(&this->jobQueueMutex);
+
+    GQueue* queue = this->jobQueue[priority];
+    for (GList* l = queue->head; l != nullptr; l = l->next) {
+        auto* job = static_cast<Job*>(l->data);
+
+        if (job->getType() != type) {
+            ranked.emplace_back(-std::numeric_limits<double>::infinity(), job);
+            continue;
+        }
+
+        double d = distance(job->getSource());
+        if (d > maxDistance) {
+            removed.push_back(job->getSource());
+            job->deleteJob();
+            job->unref();
+        } else {
+            ranked.emplace_back(d, job);
+        }
+    }
+
+    std::stable_sort(ranked.begin(), ranked.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+
+    g_queue_clear(queue);
+    for (auto const& r: ranked) {
+        g_queue_push_tail(queue, r.second);
+    }
+
+    g_mutex_unlock(&this->jobQueueMutex);
+
+    return removed;
+}
+
+void XournalScheduler::addIndexSearch(SearchIndex* index) {
+    if (existsSource(index, JOB_TYPE_SEARCH_INDEX, JOB_PRIORITY_NONE)) {
+        return;
+    }
+
+    auto* job = new SearchIndexJob(index);
+    addJob(job, JOB_PRIORITY_NONE);
+    job->unref();
+}
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -22,6 +23,8 @@
 
 #include "XournalType.h"
 
+class SearchIndex;
+
 class XournalScheduler: public Scheduler {
 public:
     XournalScheduler();
@@ -42,6 +45,25 @@ public:
     void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
     void addRerenderPage(XojPageView* view);
 
+    /**
+     * Sorts the queued RenderJob%s by the distance of their page to the visible area, so the closest pages are
+     * rendered first. The jobs of pages further away than maxDistance are removed, and the buffers of these
+     * pages are freed, so they are rendered again once they are visible.
+     */
+    void rankRenderJobs(const std::function<double(XojPageView*)>& distance, double maxDistance);
+
+    /**
+     * Like rankRenderJobs(), for the PreviewJob%s of the sidebar. The previews of removed jobs are rendered
+     * again when they are painted.
+     */
+    void rankPreviewJobs(const std::function<double(SidebarPreviewBaseEntry*)>& distance, double maxDistance);
+
+    /**
+     * Indexes pending pages of the SearchIndex, with the lowest priority
+     */
+    void addIndexSearch(SearchIndex* index);
+    void removeSearchIndex(SearchIndex* index);
+
     /**
      * Blocks until all currently running Job%s have been executed
      */
@@ -55,5 +77,14 @@ private:
 
     bool existsSource(void* source, JobType type, JobPriority priority);
 
+    /**
+     * Stable sorts the queued jobs of this type by the distance of their source, the other jobs of the
+     * queue stay in front. Jobs with a distance larger than maxDistance are removed.
+     *
+     * @return The sources of the removed jobs
+     */
+    vector<void*> rankJobs(JobType type, JobPriority priority, const std::function<double(void*)>& distance,
+                           double maxDistance);
+
 private:
 };
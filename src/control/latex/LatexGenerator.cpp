@@ -1,14 +1,23 @@
 #include "LatexGenerator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iterator>
 #include <regex>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include <glib.h>
 
+#include "PathUtil.h"
 #include "i18n.h"
 
+/**
+ * The least recently used formulas are removed, if the cache is larger
+ */
+constexpr uintmax_t CACHE_SIZE_LIMIT = 16 * 1024 * 1024;
+
 LatexGenerator::LatexGenerator(const LatexSettings& settings): settings(settings) {}
 
 auto LatexGenerator::templateSub(const std::string& input, const std::string& templ, const Color textColor)
@@ -38,6 +47,51 @@ auto LatexGenerator::templateSub(const std::string& input, const std::string& te
     return output;
 }
 
+auto LatexGenerator::getCachedPdfPath(const std::string& texFileContents) const -> fs::path {
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    // Including the terminating 0, so the command and the file cannot be merged
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(this->settings.genCmd.c_str()),
+                      this->settings.genCmd.length() + 1);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(texFileContents.c_str()), texFileContents.length());
+
+    fs::path path = Util::getCacheSubfolder("latex");
+    path /= std::string(g_checksum_get_string(checksum)) + ".pdf";
+    g_checksum_free(checksum);
+
+    return path;
+}
+
+void LatexGenerator::pruneCache() {
+    std::error_code ec;
+    fs::path root = Util::getCacheSubfolder("latex");
+
+    std::vector<std::pair<fs::file_time_type, fs::path>> files;
+    uintmax_t size = 0;
+    for (auto const& entry: fs::directory_iterator(root, ec)) {
+        if (!entry.is_regular_file(ec)) {
+            continue;
+        }
+        size += entry.file_size(ec);
+        files.emplace_back(entry.last_write_time(ec), entry.path());
+    }
+
+    if (size <= CACHE_SIZE_LIMIT) {
+        return;
+    }
+
+    std::sort(files.begin(), files.end());
+    for (auto const& f: files) {
+        if (size <= CACHE_SIZE_LIMIT) {
+            break;
+        }
+
+        uintmax_t fileSize = fs::file_size(f.second, ec);
+        if (!ec && fs::remove(f.second, ec)) {
+            size -= fileSize;
+        }
+    }
+}
+
 auto LatexGenerator::asyncRun(const fs::path& texDir, const std::string& texFileContents) -> Result {
     std::string cmd = this->settings.genCmd;
     GError* err = nullptr;
@@ -43,6 +43,19 @@ public:
      */
     Result asyncRun(const fs::path& texDir, const std::string& texFileContents);
 
+    /**
+     * Returns the path of the cached PDF for the given LaTeX file, which does not need to exist yet.
+     * The file name is a hash of the LaTeX file and the generator command, so a formula is
+     * only compiled once with the same template, color and command.
+     */
+    fs::path getCachedPdfPath(const std::string& texFileContents) const;
+
+    /**
+     * Removes the least recently used PDFs, if the cache is larger than its limit.
+     * The modification time of a cached PDF is updated when it is used.
+     */
+    static void pruneCache();
+
     /**
      * Instantiate the LaTeX template.
      */
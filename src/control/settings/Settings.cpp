@@ -1,5 +1,6 @@
 #include "Settings.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "model/FormatDefinitions.h"
@@ -88,6 +89,7 @@ void Settings::loadDefault() {
     // Set this for autosave frequency in minutes.
     this->autosaveTimeout = 3;
     this->autosaveEnabled = true;
+    this->saveCompressionLevel = 6;
 
     this->addHorizontalSpace = false;
     this->addHorizontalSpaceAmount = 150;
@@ -174,6 +176,13 @@ void Settings::loadDefault() {
     this->snapRecognizedShapesEnabled = false;
     this->restoreLineWidthEnabled = false;
 
+    this->strokeSimplificationEnabled = false;
+    this->strokeSimplificationTolerance = 0.5;
+    this->inkLatencyOverlay = false;
+    this->layerCacheEnabled = true;
+    this->progressiveRendering = true;
+    this->shareImageData = false;
+
     this->inTransaction = false;
 }
 
@@ -388,6 +397,9 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->autosaveEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autosaveTimeout")) == 0) {
         this->autosaveTimeout = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveCompressionLevel")) == 0) {
+        this->saveCompressionLevel =
+                std::clamp<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10), 1, 9);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("fullscreenHideElements")) == 0) {
         this->fullscreenHideElements = reinterpret_cast<const char*>(value);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("presentationHideElements")) == 0) {
@@ -486,6 +498,18 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->snapRecognizedShapesEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("restoreLineWidthEnabled")) == 0) {
         this->restoreLineWidthEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeSimplificationEnabled")) == 0) {
+        this->strokeSimplificationEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeSimplificationTolerance")) == 0) {
+        this->strokeSimplificationTolerance = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("inkLatencyOverlay")) == 0) {
+        this->inkLatencyOverlay = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("layerCacheEnabled")) == 0) {
+        this->layerCacheEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("progressiveRendering")) == 0) {
+        this->progressiveRendering = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("shareImageData")) == 0) {
+        this->shareImageData = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preferredLocale")) == 0) {
         this->preferredLocale = reinterpret_cast<char*>(value);
     }
@@ -814,6 +838,8 @@ void Settings::save() {
 
     WRITE_BOOL_PROP(autosaveEnabled);
     WRITE_INT_PROP(autosaveTimeout);
+    WRITE_INT_PROP(saveCompressionLevel);
+    WRITE_COMMENT("1 saves fastest, 9 creates the smallest files");
 
     WRITE_BOOL_PROP(addHorizontalSpace);
     WRITE_INT_PROP(addHorizontalSpaceAmount);
@@ -869,6 +895,22 @@ void Settings::save() {
     WRITE_BOOL_PROP(snapRecognizedShapesEnabled);
     WRITE_BOOL_PROP(restoreLineWidthEnabled);
 
+    WRITE_BOOL_PROP(strokeSimplificationEnabled);
+    WRITE_DOUBLE_PROP(strokeSimplificationTolerance);
+    WRITE_COMMENT("The maximal error of the stroke simplification, in screen pixels.");
+
+    WRITE_BOOL_PROP(inkLatencyOverlay);
+    WRITE_COMMENT("Shows the time from pen input until the stroke is painted, needs a restart");
+
+    WRITE_BOOL_PROP(layerCacheEnabled);
+    WRITE_COMMENT("Keeps the layers above and below the selected layer rendered, uses more memory per page");
+
+    WRITE_BOOL_PROP(progressiveRendering);
+    WRITE_COMMENT("Shows a fast low resolution rendering of a page first, until the page is rendered completely");
+
+    WRITE_BOOL_PROP(shareImageData);
+    WRITE_COMMENT("Saves identical images only once, such files cannot be opened by Xournal++ 1.0 and older");
+
     WRITE_INT_PROP(numIgnoredStylusEvents);
 
     WRITE_BOOL_PROP(newInputSystemEnabled);
@@ -1039,6 +1081,19 @@ void Settings::setAutosaveEnabled(bool autosave) {
     save();
 }
 
+auto Settings::getSaveCompressionLevel() const -> int { return this->saveCompressionLevel; }
+
+void Settings::setSaveCompressionLevel(int level) {
+    level = std::clamp(level, 1, 9);
+    if (this->saveCompressionLevel == level) {
+        return;
+    }
+
+    this->saveCompressionLevel = level;
+
+    save();
+}
+
 auto Settings::getAddVerticalSpace() const -> bool { return this->addVerticalSpace; }
 
 void Settings::setAddVerticalSpace(bool space) { this->addVerticalSpace = space; }
@@ -1762,6 +1817,60 @@ void Settings::setSnapRecognizedShapesEnabled(bool enabled) { this->snapRecogniz
 auto Settings::getSnapRecognizedShapesEnabled() const -> bool { return this->snapRecognizedShapesEnabled; }
 
 
+void Settings::setStrokeSimplificationEnabled(bool enabled) { this->strokeSimplificationEnabled = enabled; }
+
+auto Settings::getStrokeSimplificationEnabled() const -> bool { return this->strokeSimplificationEnabled; }
+
+void Settings::setStrokeSimplificationTolerance(double tolerance) {
+    if (this->strokeSimplificationTolerance == tolerance) {
+        return;
+    }
+    this->strokeSimplificationTolerance = tolerance;
+    save();
+}
+
+auto Settings::getStrokeSimplificationTolerance() const -> double { return this->strokeSimplificationTolerance; }
+
+void Settings::setInkLatencyOverlay(bool enabled) {
+    if (this->inkLatencyOverlay == enabled) {
+        return;
+    }
+    this->inkLatencyOverlay = enabled;
+    save();
+}
+
+auto Settings::getInkLatencyOverlay() const -> bool { return this->inkLatencyOverlay; }
+
+void Settings::setLayerCacheEnabled(bool enabled) {
+    if (this->layerCacheEnabled == enabled) {
+        return;
+    }
+    this->layerCacheEnabled = enabled;
+    save();
+}
+
+auto Settings::isLayerCacheEnabled() const -> bool { return this->layerCacheEnabled; }
+
+void Settings::setProgressiveRendering(bool enabled) {
+    if (this->progressiveRendering == enabled) {
+        return;
+    }
+    this->progressiveRendering = enabled;
+    save();
+}
+
+auto Settings::isProgressiveRendering() const -> bool { return this->progressiveRendering; }
+
+void Settings::setShareImageData(bool enabled) {
+    if (this->shareImageData == enabled) {
+        return;
+    }
+    this->shareImageData = enabled;
+    save();
+}
+
+auto Settings::isShareImageData() const -> bool { return this->shareImageData; }
+
 void Settings::setRestoreLineWidthEnabled(bool enabled) { this->restoreLineWidthEnabled = enabled; }
 
 auto Settings::getRestoreLineWidthEnabled() const -> bool { return this->restoreLineWidthEnabled; }
@@ -240,6 +240,9 @@ public:
     bool isAutosaveEnabled() const;
     void setAutosaveEnabled(bool autosave);
 
+    int getSaveCompressionLevel() const;
+    void setSaveCompressionLevel(int level);
+
     bool getAddVerticalSpace() const;
     void setAddVerticalSpace(bool space);
     int getAddVerticalSpaceAmount() const;
@@ -455,6 +458,50 @@ public:
      */
     bool getSnapRecognizedShapesEnabled() const;
 
+    /**
+     * Set stroke simplification on commit enabled
+     */
+    void setStrokeSimplificationEnabled(bool enabled);
+
+    /**
+     * Get stroke simplification on commit enabled
+     */
+    bool getStrokeSimplificationEnabled() const;
+
+    /**
+     * Set the maximal error of the stroke simplification, in screen pixels
+     */
+    void setStrokeSimplificationTolerance(double tolerance);
+
+    /**
+     * Get the maximal error of the stroke simplification, in screen pixels
+     */
+    double getStrokeSimplificationTolerance() const;
+
+    /**
+     * Show the latency from pen input until the stroke is painted on the canvas
+     */
+    void setInkLatencyOverlay(bool enabled);
+    bool getInkLatencyOverlay() const;
+
+    /**
+     * Cache the rendered layers above and below the selected layer of each page
+     */
+    void setLayerCacheEnabled(bool enabled);
+    bool isLayerCacheEnabled() const;
+
+    /**
+     * Render a low resolution draft of a page before the page itself
+     */
+    void setProgressiveRendering(bool enabled);
+    bool isProgressiveRendering() const;
+
+    /**
+     * Save identical images only once, such files cannot be opened by releases before file format version 5
+     */
+    void setShareImageData(bool enabled);
+    bool isShareImageData() const;
+
     /**
      * Set line width restoring for resized edit selctions enabled
      */
@@ -712,6 +759,11 @@ private:
      */
     int autosaveTimeout{};
 
+    /**
+     * zlib compression level of saved documents, 1 (fastest) to 9 (smallest)
+     */
+    int saveCompressionLevel{};
+
     /**
      *  Enable automatic save
      */
@@ -903,6 +955,32 @@ private:
      */
     bool snapRecognizedShapesEnabled{};
 
+    /**
+     * Whether the points of new strokes are simplified, and the maximal error in screen pixels
+     */
+    bool strokeSimplificationEnabled{};
+    double strokeSimplificationTolerance{};
+
+    /**
+     * Whether the ink latency histograms are shown on the canvas
+     */
+    bool inkLatencyOverlay{};
+
+    /**
+     * Whether edits of the selected layer only recomposite the other layers
+     */
+    bool layerCacheEnabled{};
+
+    /**
+     * Whether pages which become visible are first rendered in a low resolution
+     */
+    bool progressiveRendering{};
+
+    /**
+     * Whether identical images are saved once and referenced by the other images
+     */
+    bool shareImageData{};
+
     /**
      * Whether the line width should be preserved in a resizing operation
      */
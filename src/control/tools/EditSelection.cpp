@@ -43,9 +43,8 @@ EditSelection::EditSelection(UndoRedoHandler* undo, Selection* selection, XojPag
 
     contstruct(undo, view, view->getPage());
 
-    for (Element* e: selection->selectedElements) {
-        addElement(e, this->sourceLayer->indexOf(e));
-        this->sourceLayer->removeElement(e, false);
+    for (auto const& [e, index]: this->sourceLayer->removeElements(selection->selectedElements)) {
+        addElement(e, index);
     }
 
     view->rerenderPage();
@@ -68,9 +67,8 @@ EditSelection::EditSelection(UndoRedoHandler* undo, const vector<Element*>& elem
     calcSizeFromElements(elements);
     contstruct(undo, view, page);
 
-    for (Element* e: elements) {
-        addElement(e, this->sourceLayer->indexOf(e));
-        this->sourceLayer->removeElement(e, false);
+    for (auto const& [e, index]: this->sourceLayer->removeElements(elements)) {
+        addElement(e, index);
     }
 
     view->rerenderPage();
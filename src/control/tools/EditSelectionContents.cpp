@@ -1,5 +1,6 @@
 #include "EditSelectionContents.h"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 
@@ -27,6 +28,22 @@
 
 #include "Selection.h"
 
+/**
+ * The buffer is rendered with a higher resolution than the screen, so it can be scaled up or rotated while
+ * the selection is edited
+ */
+constexpr double BUFFER_OVERSAMPLING = 2.0;
+
+/**
+ * The oversampling is reduced for large selections, to keep the buffer below this size
+ */
+constexpr double MAX_OVERSAMPLED_BUFFER_PIXELS = 4096.0 * 4096.0 / 4;
+
+/**
+ * Time without changes of the selection, before the buffer is redrawn for the new size or zoom
+ */
+constexpr guint REPAINT_DELAY_MS = 200;
+
 EditSelectionContents::EditSelectionContents(Rectangle<double> bounds, Rectangle<double> snappedBounds,
                                              const PageRef& sourcePage, Layer* sourceLayer, XojPageView* sourceView):
         lastBounds(bounds),
@@ -55,11 +72,13 @@ EditSelectionContents::~EditSelectionContents() {
 void EditSelectionContents::addElement(Element* e, Layer::ElementIndex order) {
     g_assert(this->selected.size() == this->insertOrder.size());
     this->selected.emplace_back(e);
-    if (order == Layer::InvalidElementIndex) {
-        this->insertOrder.emplace_back(e, order);
-    } else {
-        this->insertOrder.emplace_front(e, order);
-    }
+
+    // Sorted by the index, elements without index are at the end. Usually the elements are added in this order.
+    auto it = std::find_if(this->insertOrder.rbegin(), this->insertOrder.rend(), [order](auto const& entry) {
+                  return order == Layer::InvalidElementIndex ||
+                         (entry.second != Layer::InvalidElementIndex && entry.second <= order);
+              }).base();
+    this->insertOrder.emplace(it, e, order);
 }
 
 void EditSelectionContents::replaceInsertOrder(std::deque<std::pair<Element*, Layer::ElementIndex>> newInsertOrder) {
@@ -295,6 +314,13 @@ auto EditSelectionContents::repaintSelection(EditSelectionContents* selection) -
     return false;
 }
 
+void EditSelectionContents::scheduleRepaint() {
+    if (this->rescaleId) {
+        g_source_remove(this->rescaleId);
+    }
+    this->rescaleId = g_timeout_add(REPAINT_DELAY_MS, reinterpret_cast<GSourceFunc>(repaintSelection), this);
+}
+
 /**
  * Delete our internal View buffer,
  * it will be recreated when the selection is painted next time
@@ -340,13 +366,10 @@ void EditSelectionContents::finalizeSelection(Rectangle<double> bounds, Rectangl
             e->rotate(snappedBounds.x + this->lastSnappedBounds.width / 2,
                       snappedBounds.y + this->lastSnappedBounds.height / 2, this->rotation);
         }
-        if (index == Layer::InvalidElementIndex) {
-            // if the element didn't have a source layer (e.g, clipboard)
-            layer->addElement(e);
-        } else {
-            layer->insertElement(e, index);
-        }
     }
+
+    // Elements without a source layer (e.g, clipboard) are appended
+    layer->insertElements(Layer::IndexedElements(this->insertOrder.begin(), this->insertOrder.end()));
 }
 
 auto EditSelectionContents::getOriginalX() const -> double { return this->originalBounds.x; }
@@ -429,6 +452,12 @@ void EditSelectionContents::updateContent(Rectangle<double> bounds, Rectangle<do
 
     this->lastBounds = bounds;
     this->lastSnappedBounds = snappedBounds;
+
+    // The gesture ended, redraw for the final size now
+    if (this->rescaleId) {
+        g_source_remove(this->rescaleId);
+        repaintSelection(this);
+    }
 }
 
 /**
@@ -449,12 +478,20 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
     }
 
     if (this->crBuffer == nullptr) {
-        this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width * zoom, height * zoom);
+        double pixels = width * zoom * height * zoom;
+        double oversampling = std::clamp(std::sqrt(MAX_OVERSAMPLED_BUFFER_PIXELS / pixels), 1.0, BUFFER_OVERSAMPLING);
+
+        this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width * zoom * oversampling,
+                                                    height * zoom * oversampling);
+        this->bufferWidth = width;
+        this->bufferHeight = height;
+        this->bufferZoom = zoom;
         cairo_t* cr2 = cairo_create(this->crBuffer);
 
         int dx = static_cast<int>(this->relativeX * zoom);
         int dy = static_cast<int>(this->relativeY * zoom);
 
+        cairo_scale(cr2, oversampling, oversampling);
         cairo_scale(cr2, fx, fy);
         cairo_translate(cr2, -dx, -dy);
         cairo_scale(cr2, zoom, zoom);
@@ -464,6 +501,11 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
         cairo_destroy(cr2);
     }
 
+    // Rotation is applied to the buffer, only a new size needs a redraw
+    if (width != this->bufferWidth || height != this->bufferHeight || zoom != this->bufferZoom) {
+        scheduleRepaint();
+    }
+
     cairo_save(cr);
 
     int wImg = cairo_image_surface_get_width(this->crBuffer);
@@ -475,15 +517,11 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
     double sx = static_cast<double>(wTarget) / wImg;
     double sy = static_cast<double>(hTarget) / hImg;
 
-    if (wTarget != wImg || hTarget != hImg || std::abs(rotation) > __DBL_EPSILON__) {
-        if (!this->rescaleId) {
-            this->rescaleId = g_idle_add(reinterpret_cast<GSourceFunc>(repaintSelection), this);
-        }
-        cairo_scale(cr, sx, sy);
-    }
+    cairo_scale(cr, sx, sy);
 
-    double dx = static_cast<int>(x * zoom / sx);
-    double dy = static_cast<int>(y * zoom / sy);
+    // Aligned to the pixels of the target
+    double dx = static_cast<int>(x * zoom) / sx;
+    double dy = static_cast<int>(y * zoom) / sy;
 
     cairo_set_source_surface(cr, this->crBuffer, dx, dy);
     cairo_paint(cr);
@@ -122,6 +122,12 @@ private:
      */
     static bool repaintSelection(EditSelectionContents* selection);
 
+    /**
+     * Redraws the buffer after the selection was not changed for a moment.
+     * Restarts the delay if a redraw is already scheduled.
+     */
+    void scheduleRepaint();
+
 public:
     /**
      * Gets the original view of the contents
@@ -184,10 +190,18 @@ private:
     std::deque<std::pair<Element*, Layer::ElementIndex>> insertOrder;
 
     /**
-     * The rendered elements
+     * The rendered elements. While the selection is scaled, rotated or zoomed, the buffer is transformed
+     * when painted and only redrawn when the transformation does not change anymore.
      */
     cairo_surface_t* crBuffer = nullptr;
 
+    /**
+     * The size and the zoom the buffer was rendered for
+     */
+    double bufferWidth = 0;
+    double bufferHeight = 0;
+    double bufferZoom = 0;
+
     /**
      * The source id for the rescaling task
      */
@@ -1,5 +1,6 @@
 #include "Selection.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "model/Layer.h"
@@ -116,47 +117,34 @@ void RectSelection::paint(cairo_t* cr, GdkRectangle* rect, double zoom) {
 
 //////////////////////////////////////////////////////////
 
-class RegionPoint {
-public:
-    RegionPoint(double x, double y) {
-        this->x = x;
-        this->y = y;
-    }
+/**
+ * Number of edges per band of the edge table, on average
+ */
+constexpr size_t EDGES_PER_BAND = 4;
 
-    double x;
-    double y;
-};
+constexpr size_t MAX_BANDS = 1024;
 
-RegionSelect::RegionSelect(double x, double y, Redrawable* view): Selection(view) {
-    this->points = nullptr;
-    currentPos(x, y);
-}
+RegionSelect::RegionSelect(double x, double y, Redrawable* view): Selection(view) { currentPos(x, y); }
 
-RegionSelect::~RegionSelect() {
-    for (GList* l = this->points; l != nullptr; l = l->next) {
-        delete static_cast<RegionPoint*>(l->data);
-    }
-    g_list_free(this->points);
-}
+RegionSelect::~RegionSelect() = default;
 
 void RegionSelect::paint(cairo_t* cr, GdkRectangle* rect, double zoom) {
     // at least three points needed
-    if (this->points && this->points->next && this->points->next->next) {
+    if (this->points.size() >= 3) {
         GdkRGBA selectionColor = view->getSelectionColor();
 
         // set the line always the same size on display
         cairo_set_line_width(cr, 1 / zoom);
         gdk_cairo_set_source_rgba(cr, &selectionColor);
 
-        auto* r0 = static_cast<RegionPoint*>(this->points->data);
-        cairo_move_to(cr, r0->x, r0->y);
+        const Point& r0 = this->points.front();
+        cairo_move_to(cr, r0.x, r0.y);
 
-        for (GList* l = this->points->next; l != nullptr; l = l->next) {
-            auto* r = static_cast<RegionPoint*>(l->data);
-            cairo_line_to(cr, r->x, r->y);
+        for (auto it = this->points.begin() + 1; it != this->points.end(); ++it) {
+            cairo_line_to(cr, it->x, it->y);
         }
 
-        cairo_line_to(cr, r0->x, r0->y);
+        cairo_line_to(cr, r0.x, r0.y);
 
         cairo_stroke_preserve(cr);
         auto applied = GdkRGBA{selectionColor.red, selectionColor.green, selectionColor.blue, 0.3};
@@ -166,34 +154,65 @@ void RegionSelect::paint(cairo_t* cr, GdkRectangle* rect, double zoom) {
 }
 
 void RegionSelect::currentPos(double x, double y) {
-    this->points = g_list_append(this->points, new RegionPoint(x, y));
+    if (this->points.empty()) {
+        this->x1Box = x;
+        this->x2Box = x;
+        this->y1Box = y;
+        this->y2Box = y;
+    }
+    this->points.emplace_back(x, y);
+
+    // The bounds of the lasso are kept up to date, instead of searching all points on every motion
+    this->x1Box = std::min(this->x1Box, x);
+    this->x2Box = std::max(this->x2Box, x);
+    this->y1Box = std::min(this->y1Box, y);
+    this->y2Box = std::max(this->y2Box, y);
 
     // at least three points needed
-    if (this->points && this->points->next && this->points->next->next) {
-
-        auto* r0 = static_cast<RegionPoint*>(this->points->data);
-        double ax = r0->x;
-        double bx = r0->x;
-        double ay = r0->y;
-        double by = r0->y;
-
-        for (GList* l = this->points; l != nullptr; l = l->next) {
-            auto* r = static_cast<RegionPoint*>(l->data);
-            if (ax > r->x) {
-                ax = r->x;
-            }
-            if (bx < r->x) {
-                bx = r->x;
-            }
-            if (ay > r->y) {
-                ay = r->y;
-            }
-            if (by < r->y) {
-                by = r->y;
-            }
+    if (this->points.size() >= 3) {
+        view->repaintArea(this->x1Box, this->y1Box, this->x2Box, this->y2Box);
+    }
+}
+
+void RegionSelect::createEdgeTable() {
+    size_t bandCount = std::clamp<size_t>(this->points.size() / EDGES_PER_BAND, 1, MAX_BANDS);
+    double height = this->y2Box - this->y1Box;
+    this->bandHeight = height > 0 ? height / bandCount : 1;
+
+    auto bandOf = [&](double y) {
+        return std::min(bandCount - 1, static_cast<size_t>(std::max(0.0, (y - this->y1Box) / this->bandHeight)));
+    };
+
+    // Edges from the last point to the first one, and so on. Horizontal edges are never crossed.
+    vector<Edge> edges;
+    edges.reserve(this->points.size());
+    const Point* last = &this->points.back();
+    for (const Point& p: this->points) {
+        if (p.y < last->y) {
+            edges.push_back({p.x, p.y, last->x, last->y});
+        } else if (p.y > last->y) {
+            edges.push_back({last->x, last->y, p.x, p.y});
+        }
+        last = &p;
+    }
+
+    // Counting sort of the edges into all bands they cross
+    this->bandStart.assign(bandCount + 1, 0);
+    for (const Edge& e: edges) {
+        for (size_t b = bandOf(e.y1), end = bandOf(e.y2); b <= end; b++) {
+            this->bandStart[b + 1]++;
         }
+    }
+    for (size_t b = 0; b < bandCount; b++) {
+        this->bandStart[b + 1] += this->bandStart[b];
+    }
 
-        view->repaintArea(ax, ay, bx, by);
+    this->bandEdges.resize(this->bandStart[bandCount]);
+    vector<size_t> fill(this->bandStart.begin(), this->bandStart.end() - 1);
+    for (const Edge& e: edges) {
+        for (size_t b = bandOf(e.y1), end = bandOf(e.y2); b <= end; b++) {
+            this->bandEdges[fill[b]++] = e;
+        }
     }
 }
 
@@ -204,65 +223,23 @@ auto RegionSelect::contains(double x, double y) -> bool {
     if (y < this->y1Box || y > this->y2Box) {
         return false;
     }
-    if (this->points == nullptr || this->points->next == nullptr) {
+    if (this->bandStart.empty()) {
         return false;
     }
 
-    int hits = 0;
-
-    auto* last = static_cast<RegionPoint*>(g_list_last(this->points)->data);
-
-    double lastx = last->x;
-    double lasty = last->y;
-    double curx = NAN, cury = NAN;
+    size_t bandCount = this->bandStart.size() - 1;
+    size_t band = std::min(bandCount - 1, static_cast<size_t>((y - this->y1Box) / this->bandHeight));
 
-    // Walk the edges of the polygon
-    for (GList* l = this->points; l != nullptr; lastx = curx, lasty = cury, l = l->next) {
-        auto* last = static_cast<RegionPoint*>(l->data);
-        curx = last->x;
-        cury = last->y;
-
-        if (cury == lasty) {
+    // Count the edges on the right side of the point
+    int hits = 0;
+    for (size_t i = this->bandStart[band]; i < this->bandStart[band + 1]; i++) {
+        const Edge& e = this->bandEdges[i];
+        if (y < e.y1 || y >= e.y2) {
             continue;
         }
-
-        int leftx = 0;
-        if (curx < lastx) {
-            if (x >= lastx) {
-                continue;
-            }
-            leftx = curx;
-        } else {
-            if (x >= curx) {
-                continue;
-            }
-            leftx = lastx;
-        }
-
-        double test1 = NAN, test2 = NAN;
-        if (cury < lasty) {
-            if (y < cury || y >= lasty) {
-                continue;
-            }
-            if (x < leftx) {
-                hits++;
-                continue;
-            }
-            test1 = x - curx;
-            test2 = y - cury;
-        } else {
-            if (y < lasty || y >= cury) {
-                continue;
-            }
-            if (x < leftx) {
-                hits++;
-                continue;
-            }
-            test1 = x - lastx;
-            test2 = y - lasty;
-        }
-
-        if (test1 < (test2 / (lasty - cury) * (lastx - curx))) {
+        if (x < std::min(e.x1, e.x2)) {
+            hits++;
+        } else if (x < std::max(e.x1, e.x2) && x < e.x1 + (y - e.y1) / (e.y2 - e.y1) * (e.x2 - e.x1)) {
             hits++;
         }
     }
@@ -273,29 +250,17 @@ auto RegionSelect::contains(double x, double y) -> bool {
 auto RegionSelect::finalize(PageRef page) -> bool {
     this->page = page;
 
-    this->x1Box = 0;
-    this->x2Box = 0;
-    this->y1Box = 0;
-    this->y2Box = 0;
-
-    for (GList* l = this->points; l != nullptr; l = l->next) {
-        auto* p = static_cast<RegionPoint*>(l->data);
-
-        if (p->x < this->x1Box) {
-            this->x1Box = p->x;
-        } else if (p->x > this->x2Box) {
-            this->x2Box = p->x;
-        }
-
-        if (p->y < this->y1Box) {
-            this->y1Box = p->y;
-        } else if (p->y > this->y2Box) {
-            this->y2Box = p->y;
-        }
-    }
+    createEdgeTable();
 
     Layer* l = page->getSelectedLayer();
     for (Element* e: *l->getElements()) {
+        // The points of strokes and the corners of other elements are tested, they are within the snapped bounds
+        Rectangle<double> bounds = e->getSnappedBounds();
+        if (bounds.x < this->x1Box || bounds.x + bounds.width > this->x2Box || bounds.y < this->y1Box ||
+            bounds.y + bounds.height > this->y2Box) {
+            continue;
+        }
+
         if (e->isInSelection(this)) {
             this->selectedElements.push_back(e);
         }
@@ -308,10 +273,9 @@ auto RegionSelect::finalize(PageRef page) -> bool {
 
 auto RegionSelect::userTapped(double zoom) -> bool {
     double maxDist = 10 / zoom;
-    auto* r0 = static_cast<RegionPoint*>(this->points->data);
-    for (GList* l = this->points; l != nullptr; l = l->next) {
-        auto* p = static_cast<RegionPoint*>(l->data);
-        if (r0->x - p->x > maxDist || p->x - r0->x > maxDist || r0->y - p->y > maxDist || p->y - r0->y > maxDist) {
+    const Point& r0 = this->points.front();
+    for (const Point& p: this->points) {
+        if (r0.x - p.x > maxDist || p.x - r0.x > maxDist || r0.y - p.y > maxDist || p.y - r0.y > maxDist) {
             return false;
         }
     }
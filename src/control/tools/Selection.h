@@ -17,6 +17,7 @@
 #include "gui/Redrawable.h"
 #include "model/Element.h"
 #include "model/PageRef.h"
+#include "model/Point.h"
 
 #include "Util.h"
 #include "XournalType.h"
@@ -87,5 +88,28 @@ public:
     virtual bool userTapped(double zoom);
 
 private:
-    GList* points;
+    /**
+     * An edge of the lasso polygon, y1 < y2
+     */
+    struct Edge {
+        double x1;
+        double y1;
+        double x2;
+        double y2;
+    };
+
+    /**
+     * Sorts the edges of the polygon into horizontal bands, contains() only tests the edges of one band
+     */
+    void createEdgeTable();
+
+private:
+    vector<Point> points;
+
+    /**
+     * The edges crossing each band, the edges of band i are bandEdges[bandStart[i]] to bandEdges[bandStart[i + 1]]
+     */
+    vector<Edge> bandEdges;
+    vector<size_t> bandStart;
+    double bandHeight = 1;
 };
@@ -9,6 +9,7 @@
 #include "control/layer/LayerController.h"
 #include "control/settings/Settings.h"
 #include "control/shaperecognizer/ShapeRecognizerResult.h"
+#include "gui/InkLatency.h"
 #include "gui/PageView.h"
 #include "gui/XournalView.h"
 #include "undo/InsertUndoAction.h"
@@ -58,6 +59,8 @@ auto StrokeHandler::onMotionNotifyEvent(const PositionInputData& pos) -> bool {
         return false;
     }
 
+    gint64 handlerStart = g_get_monotonic_time();
+
     double zoom = xournal->getZoom();
     double x = pos.x / zoom;
     double y = pos.y / zoom;
@@ -111,6 +114,10 @@ auto StrokeHandler::onMotionNotifyEvent(const PositionInputData& pos) -> bool {
     this->redrawable->repaintRect(stroke->getX() - w, stroke->getY() - w, stroke->getElementWidth() + 2 * w,
                                   stroke->getElementHeight() + 2 * w);
 
+    if (InkLatency* latency = xournal->getInkLatency()) {
+        latency->strokeMotion(pos.timestamp, handlerStart);
+    }
+
     return true;
 }
 
@@ -201,6 +208,11 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos) {
         }
     }
 
+    if (settings->getStrokeSimplificationEnabled()) {
+        // The tolerance is given in screen pixels, so the simplification is not visible at the current zoom
+        stroke->simplify(settings->getStrokeSimplificationTolerance() / xournal->getZoom());
+    }
+
     if (stroke->getFill() != -1 && stroke->getToolType() == STROKE_TOOL_HIGHLIGHTER) {
         // The stroke is not filled on drawing time
         // If the stroke has fill values, it needs to be re-rendered
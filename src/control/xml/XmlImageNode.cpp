@@ -1,5 +1,13 @@
 #include "XmlImageNode.h"
 
+#include <algorithm>
+#include <utility>
+
+/**
+ * Size of the chunks of PNG data which are base64 encoded at once, a multiple of 3 so no padding is inserted
+ */
+constexpr size_t BASE64_CHUNK_SIZE = 3 * 16384;
+
 XmlImageNode::XmlImageNode(const char* tag): XmlNode(tag) {
     this->img = nullptr;
     this->out = nullptr;
@@ -19,6 +27,8 @@ void XmlImageNode::setImage(cairo_surface_t* img) {
     this->img = cairo_surface_reference(img);
 }
 
+void XmlImageNode::setPngData(std::shared_ptr<const std::string> png) { this->png = std::move(png); }
+
 auto XmlImageNode::pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length)
         -> cairo_status_t {
     for (unsigned int i = 0; i < length; i++, image->pos++) {
@@ -41,15 +51,26 @@ void XmlImageNode::writeOut(OutputStream* out) {
 
     out->write(">");
 
-    if (this->img == nullptr) {
+    if (this->png) {
+        out->setBinaryContent(true);
+        for (size_t pos = 0; pos < this->png->size(); pos += BASE64_CHUNK_SIZE) {
+            size_t len = std::min(BASE64_CHUNK_SIZE, this->png->size() - pos);
+            gchar* base64_str = g_base64_encode(reinterpret_cast<const guchar*>(this->png->data() + pos), len);
+            out->write(base64_str);
+            g_free(base64_str);
+        }
+        out->setBinaryContent(false);
+    } else if (this->img == nullptr) {
         g_error("XmlImageNode::writeOut(); this->img == nullptr");
     } else {
         this->out = out;
         this->pos = 0;
+        out->setBinaryContent(true);
         cairo_surface_write_to_png_stream(this->img, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction), this);
         gchar* base64_str = g_base64_encode(this->buffer, this->pos);
         out->write(base64_str);
         g_free(base64_str);
+        out->setBinaryContent(false);
 
         this->out = nullptr;
     }
@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "XmlNode.h"
 
 class XmlImageNode: public XmlNode {
@@ -21,12 +24,18 @@ public:
 public:
     void setImage(cairo_surface_t* img);
 
+    /**
+     * Writes already encoded PNG data, instead of encoding an image
+     */
+    void setPngData(std::shared_ptr<const std::string> png);
+
     static cairo_status_t pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length);
 
     virtual void writeOut(OutputStream* out);
 
 private:
     cairo_surface_t* img;
+    std::shared_ptr<const std::string> png;
 
     OutputStream* out;
     int pos;
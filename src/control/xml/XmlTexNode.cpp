@@ -13,7 +13,9 @@ void XmlTexNode::writeOut(OutputStream* out) {
 
     gchar* base64_str =
             g_base64_encode(reinterpret_cast<const guchar*>(this->binaryData.c_str()), this->binaryData.length());
+    out->setBinaryContent(true);
     out->write(base64_str);
+    out->setBinaryContent(false);
     g_free(base64_str);
 
     out->write("</");
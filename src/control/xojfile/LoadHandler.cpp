@@ -77,6 +77,8 @@ void LoadHandler::initAttributes() {
     this->teximage = nullptr;
     this->text = nullptr;
     this->pages.clear();
+    this->images.clear();
+    this->texImages.clear();
 
     if (this->audioFiles) {
         g_hash_table_unref(this->audioFiles);
@@ -630,6 +632,22 @@ void LoadHandler::parseImage() {
     this->image->setY(top);
     this->image->setWidth(right - left);
     this->image->setHeight(bottom - top);
+
+    // Identical images are only stored once, the following ones reference the first one by its hash
+    const char* ref = LoadHandlerHelper::getAttrib("ref", true, this);
+    if (ref != nullptr) {
+        auto it = this->images.find(ref);
+        if (it != this->images.end()) {
+            this->image->shareImage(it->second);
+        } else {
+            error("%s", FC(_F("Unknown image reference: {1}") % ref));
+        }
+    }
+
+    const char* hash = LoadHandlerHelper::getAttrib("hash", true, this);
+    if (hash != nullptr) {
+        this->images[hash] = this->image;
+    }
 }
 
 void LoadHandler::parseTexImage() {
@@ -653,6 +671,21 @@ void LoadHandler::parseTexImage() {
     this->teximage->setHeight(bottom - top);
 
     this->teximage->setText(string(imText, imTextLen));
+
+    const char* ref = LoadHandlerHelper::getAttrib("ref", true, this);
+    if (ref != nullptr) {
+        auto it = this->texImages.find(ref);
+        if (it != this->texImages.end()) {
+            this->teximage->loadData(string(it->second->getBinaryData()));
+        } else {
+            error("%s", FC(_F("Unknown image reference: {1}") % ref));
+        }
+    }
+
+    const char* hash = LoadHandlerHelper::getAttrib("hash", true, this);
+    if (hash != nullptr) {
+        this->texImages[hash] = this->teximage;
+    }
 }
 
 void LoadHandler::parseAttachment() {
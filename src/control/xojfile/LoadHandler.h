@@ -13,6 +13,7 @@
 
 #include <regex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <zip.h>
@@ -138,6 +139,12 @@ private:
     TexImage* teximage;
     GHashTable* audioFiles = nullptr;
 
+    /**
+     * Images and TeX images by the hash of their data, to resolve the references to identical ones
+     */
+    std::unordered_map<string, Image*> images;
+    std::unordered_map<string, TexImage*> texImages;
+
     const char* endRootTag = "xournal";
 
     fs::path xournalFilepath;
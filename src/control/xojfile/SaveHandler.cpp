@@ -23,10 +23,18 @@
 #include "PathUtil.h"
 #include "i18n.h"
 
+/**
+ * Version of files without references to shared images, which can be opened by older releases
+ */
+static constexpr int FILE_FORMAT_VERSION_WITHOUT_REFS = 4;
+
 SaveHandler::SaveHandler() {
     this->root = nullptr;
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
+    this->compressionLevel = Z_DEFAULT_COMPRESSION;
+    this->sharePayloads = false;
+    this->payloadReferenced = false;
     this->backgroundImages = nullptr;
 }
 
@@ -55,6 +63,8 @@ void SaveHandler::prepareSave(Document* doc) {
 
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
+    this->storedPayloads.clear();
+    this->payloadReferenced = false;
 
     this->root = new XmlNode("xournal");
 
@@ -76,11 +86,21 @@ void SaveHandler::prepareSave(Document* doc) {
         PageRef p = doc->getPage(i);
         visitPage(this->root, p, doc, i);
     }
+
+    if (this->payloadReferenced) {
+        // Older releases would load the referencing images empty, they warn about newer file versions
+        this->root->setAttrib("fileversion", FILE_FORMAT_VERSION);
+    }
 }
 
+void SaveHandler::setCompressionLevel(int level) { this->compressionLevel = level; }
+
+void SaveHandler::setSharePayloads(bool share) { this->sharePayloads = share; }
+
 void SaveHandler::writeHeader() {
     this->root->setAttrib("creator", PROJECT_STRING);
-    this->root->setAttrib("fileversion", FILE_FORMAT_VERSION);
+    // Raised to FILE_FORMAT_VERSION by prepareSave() if an image references shared data
+    this->root->setAttrib("fileversion", FILE_FORMAT_VERSION_WITHOUT_REFS);
     this->root->addChild(new XmlTextNode("title", std::string{"Xournal++ document - see "} + PROJECT_URL));
 }
 
@@ -97,6 +117,14 @@ void SaveHandler::writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAu
     xmlAudioNode->setAttrib("fn", audioElement->getAudioFilename());
 }
 
+auto SaveHandler::isPayloadStored(const string& hash) -> bool {
+    if (!this->sharePayloads || this->storedPayloads.insert(hash).second) {
+        return false;
+    }
+    this->payloadReferenced = true;
+    return true;
+}
+
 void SaveHandler::visitStroke(XmlPointNode* stroke, Stroke* s) {
     StrokeTool t = s->getToolType();
 
@@ -177,18 +205,45 @@ void SaveHandler::visitLayer(XmlNode* page, Layer* l) {
             writeTimestamp(t, text);
         } else if (e->getType() == ELEMENT_IMAGE) {
             auto* i = dynamic_cast<Image*>(e);
-            auto* image = new XmlImageNode("image");
-            layer->addChild(image);
+            string hash = this->sharePayloads ? i->getPngHash() : "";
+            bool stored = isPayloadStored(hash);
 
-            image->setImage(i->getImage());
+            XmlNode* image = nullptr;
+            if (stored) {
+                image = new XmlNode("image");
+            } else {
+                // Images loaded from a file are not encoded again
+                auto* imageNode = new XmlImageNode("image");
+                imageNode->setPngData(i->getPngData());
+                image = imageNode;
+            }
+            layer->addChild(image);
 
             image->setAttrib("left", i->getX());
             image->setAttrib("top", i->getY());
             image->setAttrib("right", i->getX() + i->getElementWidth());
             image->setAttrib("bottom", i->getY() + i->getElementHeight());
+            if (this->sharePayloads) {
+                image->setAttrib(stored ? "ref" : "hash", hash);
+            }
         } else if (e->getType() == ELEMENT_TEXIMAGE) {
             auto* i = dynamic_cast<TexImage*>(e);
-            auto* image = new XmlTexNode("teximage", std::string(i->getBinaryData()));
+            const string& data = i->getBinaryData();
+            string hash;
+            if (this->sharePayloads) {
+                gchar* hashStr = g_compute_checksum_for_data(G_CHECKSUM_SHA1,
+                                                             reinterpret_cast<const guchar*>(data.data()), data.size());
+                hash = hashStr;
+                g_free(hashStr);
+            }
+            bool stored = isPayloadStored(hash);
+
+            XmlNode* image = nullptr;
+            if (stored) {
+                image = new XmlNode("teximage");
+            } else {
+                image = new XmlTexNode("teximage", std::string(data));
+            }
             layer->addChild(image);
 
             image->setAttrib("text", i->getText().c_str());
@@ -196,6 +251,9 @@ void SaveHandler::visitLayer(XmlNode* page, Layer* l) {
             image->setAttrib("top", i->getY());
             image->setAttrib("right", i->getX() + i->getElementWidth());
             image->setAttrib("bottom", i->getY() + i->getElementHeight());
+            if (this->sharePayloads) {
+                image->setAttrib(stored ? "ref" : "hash", hash);
+            }
         }
     }
 }
@@ -227,7 +285,11 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
                 background->setAttrib("filename", "bg.pdf");
 
                 GError* error = nullptr;
-                doc->getPdfDocument().save(filepath, &error);
+                std::error_code ec;
+                // The attached PDF is never modified, it only needs to be copied if the document is saved elsewhere
+                if (!fs::equivalent(filepath, doc->getPdfFilepath(), ec)) {
+                    doc->getPdfDocument().save(filepath, &error);
+                }
 
                 if (error) {
                     if (!this->errorMessage.empty()) {
@@ -299,7 +361,7 @@ void SaveHandler::writeSolidBackground(XmlNode* background, PageRef p) {
 }
 
 void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
-    GzOutputStream out(filepath);
+    GzOutputStream out(filepath, this->compressionLevel);
 
     if (!out.getLastError().empty()) {
         this->errorMessage = out.getLastError();
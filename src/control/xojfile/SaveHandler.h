@@ -12,6 +12,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "control/xml/XmlAudioNode.h"
@@ -33,6 +34,17 @@ public:
 
 public:
     void prepareSave(Document* doc);
+
+    /**
+     * zlib compression level (1 - 9) of saveTo(const fs::path&, ProgressListener*)
+     */
+    void setCompressionLevel(int level);
+
+    /**
+     * Write identical images only once. Files which contain such references need FILE_FORMAT_VERSION,
+     * older releases load the referencing images empty.
+     */
+    void setSharePayloads(bool share);
     void saveTo(const fs::path& filepath, ProgressListener* listener = nullptr);
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
     string getErrorMessage();
@@ -53,10 +65,28 @@ protected:
     virtual void writeSolidBackground(XmlNode* background, PageRef p);
     virtual void writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode);
 
+    /**
+     * @return true if the data with this hash was already written, the element only references it
+     */
+    bool isPayloadStored(const string& hash);
+
 protected:
     XmlNode* root;
     bool firstPdfPageVisited;
     int attachBgId;
+    int compressionLevel;
+
+    /**
+     * Identical images are only written once, and referenced by the hash of their data.
+     * Not supported by Xournal and releases before file format version 5.
+     */
+    bool sharePayloads;
+
+    /**
+     * If an element references the data of another element, the file needs FILE_FORMAT_VERSION
+     */
+    bool payloadReferenced;
+    std::unordered_set<string> storedPayloads;
 
     string errorMessage;
 
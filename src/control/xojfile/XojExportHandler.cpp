@@ -19,7 +19,10 @@
 
 #include "i18n.h"
 
-XojExportHandler::XojExportHandler() = default;
+XojExportHandler::XojExportHandler() {
+    // Xournal cannot read image references
+    this->sharePayloads = false;
+}
 
 XojExportHandler::~XojExportHandler() = default;
 
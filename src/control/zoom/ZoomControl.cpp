@@ -98,6 +98,9 @@ void ZoomControl::startZoomSequence(utl::Point<double> zoomCenter) {
     this->zoomSequenceStart = this->zoom;
 
     setScrollPositionAfterZoom(view_pos);
+
+    // Until the pages are rendered at the new zoom, the closest zoom level is shown
+    this->view->createZoomLevels();
 }
 
 void ZoomControl::zoomSequenceChange(double zoom, bool relative) {
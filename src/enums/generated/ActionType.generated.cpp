@@ -166,6 +166,10 @@ auto ActionType_fromString(const string& value) -> ActionType {
         return ACTION_PAPER_BACKGROUND_COLOR;
     }
 
+    if (value == "ACTION_SIMPLIFY_STROKES") {
+        return ACTION_SIMPLIFY_STROKES;
+    }
+
     if (value == "ACTION_TOOL_PEN") {
         return ACTION_TOOL_PEN;
     }
@@ -745,6 +749,10 @@ auto ActionType_toString(ActionType value) -> string {
         return "ACTION_PAPER_BACKGROUND_COLOR";
     }
 
+    if (value == ACTION_SIMPLIFY_STROKES) {
+        return "ACTION_SIMPLIFY_STROKES";
+    }
+
     if (value == ACTION_TOOL_PEN) {
         return "ACTION_TOOL_PEN";
     }
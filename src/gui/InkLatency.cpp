@@ -0,0 +1,191 @@
+#include "InkLatency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "gui/scroll/ScrollHandling.h"
+
+#include "i18n.h"
+
+/**
+ * GDK event timestamps are the lower 32 bit of the monotonic clock in ms on X11 and Wayland. If the
+ * difference is larger, the clocks do not match and the input stage is not measured.
+ */
+constexpr guint32 MAX_INPUT_LATENCY_MS = 1000;
+
+/**
+ * Distance of the overlay from the top left corner of the visible area, and of the text from its border
+ */
+constexpr int OVERLAY_MARGIN = 10;
+constexpr int OVERLAY_PADDING = 6;
+
+InkLatency::InkLatency(GtkWidget* widget, ScrollHandling* scrollHandling):
+        widget(widget), scrollHandling(scrollHandling) {
+    this->scrolledHandler[0] = g_signal_connect(scrollHandling->getHorizontal(), "value-changed",
+                                                G_CALLBACK(&InkLatency::scrolled), this);
+    this->scrolledHandler[1] = g_signal_connect(scrollHandling->getVertical(), "value-changed",
+                                                G_CALLBACK(&InkLatency::scrolled), this);
+}
+
+InkLatency::~InkLatency() {
+    g_signal_handler_disconnect(this->scrollHandling->getHorizontal(), this->scrolledHandler[0]);
+    g_signal_handler_disconnect(this->scrollHandling->getVertical(), this->scrolledHandler[1]);
+
+    if (this->afterPaintHandler) {
+        g_signal_handler_disconnect(this->frameClock, this->afterPaintHandler);
+    }
+    if (this->frameClock) {
+        g_object_unref(this->frameClock);
+    }
+}
+
+void InkLatency::Histogram::add(gint64 us) {
+    size_t bucket = std::clamp<gint64>(us / BUCKET_US, 0, buckets.size() - 1);
+    buckets[bucket]++;
+    count++;
+}
+
+auto InkLatency::Histogram::percentile(double p) const -> double {
+    if (count == 0) {
+        return 0;
+    }
+
+    auto target = static_cast<size_t>(p * (count - 1)) + 1;
+    size_t sum = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        sum += buckets[i];
+        if (sum >= target) {
+            // Upper bound of the bucket, in ms
+            return (i + 1) * BUCKET_US / 1000.0;
+        }
+    }
+    return buckets.size() * BUCKET_US / 1000.0;
+}
+
+auto InkLatency::Histogram::getCount() const -> size_t { return count; }
+
+void InkLatency::strokeMotion(guint32 eventTime, gint64 handlerStart) {
+    if (this->frameClock == nullptr) {
+        this->frameClock = gtk_widget_get_frame_clock(this->widget);
+        if (this->frameClock == nullptr) {
+            // Not realized yet
+            return;
+        }
+        g_object_ref(this->frameClock);
+        this->afterPaintHandler =
+                g_signal_connect(this->frameClock, "after-paint", G_CALLBACK(afterPaint), this);
+    }
+
+    // Unsigned, so the difference is also correct if the 32 bit timestamp has wrapped
+    guint32 inputMs = static_cast<guint32>(handlerStart / 1000) - eventTime;
+    gint64 eventStart = inputMs <= MAX_INPUT_LATENCY_MS ? handlerStart - gint64{inputMs} * 1000 : -1;
+
+    this->pending.push_back({eventStart, handlerStart, g_get_monotonic_time()});
+}
+
+void InkLatency::afterPaint(GdkFrameClock* clock, InkLatency* self) {
+    if (self->pending.empty()) {
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    for (const Sample& s: self->pending) {
+        if (s.eventTime >= 0) {
+            self->input.add(s.handlerStart - s.eventTime);
+        }
+        self->handler.add(s.handlerEnd - s.handlerStart);
+        self->paint.add(now - s.handlerEnd);
+        self->total.add(now - (s.eventTime >= 0 ? s.eventTime : s.handlerStart));
+    }
+    self->pending.clear();
+
+    self->queueOverlayDraw();
+}
+
+void InkLatency::scrolled(GtkAdjustment* adjustment, InkLatency* self) {
+    if (self->overlayRect.width == 0) {
+        return;
+    }
+
+    // The old area may have been moved along with the scrolled content
+    self->queueOverlayDraw();
+
+    int x = 0;
+    int y = 0;
+    self->getVisibleOrigin(x, y);
+    self->overlayRect.x = x + OVERLAY_MARGIN;
+    self->overlayRect.y = y + OVERLAY_MARGIN;
+    self->queueOverlayDraw();
+}
+
+void InkLatency::getVisibleOrigin(int& x, int& y) const {
+    // Document coordinates of the widget origin, they are only translated if the widget scrolls itself
+    double originX = 0;
+    double originY = 0;
+    this->scrollHandling->translate(originX, originY);
+
+    x = static_cast<int>(std::lround(gtk_adjustment_get_value(this->scrollHandling->getHorizontal()) - originX));
+    y = static_cast<int>(std::lround(gtk_adjustment_get_value(this->scrollHandling->getVertical()) - originY));
+}
+
+void InkLatency::queueOverlayDraw() {
+    if (this->overlayRect.width > 0) {
+        gtk_widget_queue_draw_area(this->widget, this->overlayRect.x, this->overlayRect.y, this->overlayRect.width,
+                                   this->overlayRect.height);
+    }
+}
+
+auto InkLatency::formatStage(const char* name, const Histogram& h) const -> string {
+    char line[64];
+    snprintf(line, sizeof(line), "%-8s %7.1f %7.1f", name, h.percentile(0.5), h.percentile(0.99));
+    return line;
+}
+
+auto InkLatency::formatTable() const -> string {
+    char header[64];
+    snprintf(header, sizeof(header), "%-8s %7s %7s", "", "p50", "p99");
+    return string(header) + "\n" + formatStage("input", this->input) + "\n" + formatStage("handler", this->handler) +
+           "\n" + formatStage("paint", this->paint) + "\n" + formatStage("total", this->total);
+}
+
+void InkLatency::drawOverlay(cairo_t* cr) {
+    string text = FS(_F("Ink latency (ms), {1} samples") % this->total.getCount()) + "\n" + formatTable();
+
+    PangoLayout* layout = pango_cairo_create_layout(cr);
+    PangoFontDescription* font = pango_font_description_from_string("Monospace 9");
+    pango_layout_set_font_description(layout, font);
+    pango_font_description_free(font);
+    pango_layout_set_text(layout, text.c_str(), -1);
+
+    int width = 0;
+    int height = 0;
+    pango_layout_get_pixel_size(layout, &width, &height);
+
+    int x = 0;
+    int y = 0;
+    getVisibleOrigin(x, y);
+    x += OVERLAY_MARGIN;
+    y += OVERLAY_MARGIN;
+    this->overlayRect = {x, y, width + 2 * OVERLAY_PADDING, height + 2 * OVERLAY_PADDING};
+
+    cairo_save(cr);
+    cairo_set_source_rgba(cr, 0, 0, 0, 0.7);
+    cairo_rectangle(cr, this->overlayRect.x, this->overlayRect.y, this->overlayRect.width, this->overlayRect.height);
+    cairo_fill(cr);
+
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_move_to(cr, x + OVERLAY_PADDING, y + OVERLAY_PADDING);
+    pango_cairo_show_layout(cr, layout);
+    cairo_restore(cr);
+
+    g_object_unref(layout);
+}
+
+void InkLatency::dump() {
+    if (this->total.getCount() == 0) {
+        return;
+    }
+
+    g_message("Ink latency (ms), %zu samples\n%s", this->total.getCount(), formatTable().c_str());
+}
@@ -0,0 +1,119 @@
+/*
+ * Xournal++
+ *
+ * Measures the time from a pen motion event until the stroke is on screen
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <gtk/gtk.h>
+
+#include "XournalType.h"
+
+class ScrollHandling;
+
+/**
+ * Enabled with the setting "inkLatencyOverlay". Each motion event of a stroke is split into stages:
+ *  - input: from the event timestamp until StrokeHandler::onMotionNotifyEvent is called
+ *  - handler: until onMotionNotifyEvent has requested the repaint
+ *  - paint: until the next frame was painted (GdkFrameClock::after-paint)
+ * The histograms are shown on the canvas and written to the log when the view is closed.
+ */
+class InkLatency {
+public:
+    InkLatency(GtkWidget* widget, ScrollHandling* scrollHandling);
+    virtual ~InkLatency();
+
+public:
+    /**
+     * Called after a motion event of a stroke was handled
+     *
+     * @param eventTime The timestamp of the GdkEvent, in ms
+     * @param handlerStart g_get_monotonic_time() when the handler was called
+     */
+    void strokeMotion(guint32 eventTime, gint64 handlerStart);
+
+    /**
+     * Draws the percentiles in the top left corner of the visible area, cr is in widget coordinates
+     */
+    void drawOverlay(cairo_t* cr);
+
+    /**
+     * Writes the percentiles to the log
+     */
+    void dump();
+
+private:
+    /**
+     * Linear buckets of 0.1 ms up to 200 ms, the last one counts everything slower
+     */
+    class Histogram {
+    public:
+        void add(gint64 us);
+        double percentile(double p) const;
+        size_t getCount() const;
+
+    private:
+        static constexpr gint64 BUCKET_US = 100;
+        std::array<uint32_t, 2001> buckets{};
+        size_t count = 0;
+    };
+
+    struct Sample {
+        /**
+         * Monotonic time of the event, -1 if the event timestamp cannot be compared
+         */
+        gint64 eventTime;
+        gint64 handlerStart;
+        gint64 handlerEnd;
+    };
+
+    static void afterPaint(GdkFrameClock* clock, InkLatency* self);
+
+    /**
+     * The overlay stays on screen, so it moves within the widget when it is scrolled
+     */
+    static void scrolled(GtkAdjustment* adjustment, InkLatency* self);
+
+    /**
+     * @return The top left corner of the visible area in widget coordinates. If GTK scrolls the widget,
+     * the widget is as large as the document.
+     */
+    void getVisibleOrigin(int& x, int& y) const;
+
+    void queueOverlayDraw();
+
+    string formatStage(const char* name, const Histogram& h) const;
+    string formatTable() const;
+
+private:
+    GtkWidget* widget = nullptr;
+    ScrollHandling* scrollHandling = nullptr;
+    gulong scrolledHandler[2] = {0, 0};
+    GdkFrameClock* frameClock = nullptr;
+    gulong afterPaintHandler = 0;
+
+    /**
+     * Motion events which are not painted yet
+     */
+    std::vector<Sample> pending;
+
+    Histogram input;
+    Histogram handler;
+    Histogram paint;
+    Histogram total;
+
+    /**
+     * Area of the overlay in widget coordinates, repainted after new samples were added
+     */
+    GdkRectangle overlayRect{0, 0, 0, 0};
+};
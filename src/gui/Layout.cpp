@@ -26,6 +26,11 @@ constexpr size_t const XOURNAL_ROOM_FOR_SHADOW = 3;
  */
 constexpr size_t const XOURNAL_PADDING_BETWEEN = 15;
 
+/**
+ * Queued render jobs of pages further away from the visible area than this many screens are dropped
+ */
+constexpr double const RENDER_PREFETCH_SCREENS = 1.0;
+
 
 Layout::Layout(XournalView* view, ScrollHandling* scrollHandling): view(view), scrollHandling(scrollHandling) {
     g_signal_connect(scrollHandling->getHorizontal(), "value-changed", G_CALLBACK(horizontalScrollChanged), this);
@@ -104,6 +109,16 @@ void Layout::updateVisibility() {
     if (mostPageNr) {
         this->view->getControl()->firePageSelected(*mostPageNr);
     }
+
+    // Render the pages closest to the visible area first, and forget the pages scrolled far away
+    auto distance = [&visRect](XojPageView* pageView) {
+        auto const& r = pageView->getRect();
+        double dx = std::max({0.0, r.x - (visRect.x + visRect.width), visRect.x - (r.x + r.width)});
+        double dy = std::max({0.0, r.y - (visRect.y + visRect.height), visRect.y - (r.y + r.height)});
+        return dx + dy;
+    };
+    double prefetch = RENDER_PREFETCH_SCREENS * std::max(visRect.width, visRect.height);
+    this->view->getControl()->getScheduler()->rankRenderJobs(distance, prefetch);
 }
 
 auto Layout::getVisibleRect() -> Rectangle<double> {
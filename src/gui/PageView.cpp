@@ -4,6 +4,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <memory>
+#include <utility>
 
 #include <gdk/gdk.h>
 
@@ -49,6 +50,17 @@
 #include "i18n.h"
 #include "pixbuf-utils.h"
 
+/**
+ * Number of downscaled renderings kept for zooming out, and of former renderings for zooming back in
+ */
+constexpr int MAX_LOWER_ZOOM_LEVELS = 2;
+constexpr int MAX_UPPER_ZOOM_LEVELS = 2;
+
+/**
+ * Smaller zoom levels are not worth to be kept
+ */
+constexpr int MIN_ZOOM_LEVEL_SIZE = 64;
+
 XojPageView::XojPageView(XournalView* xournal, const PageRef& page) {
     this->page = page;
     this->registerListener(this->page);
@@ -58,6 +70,7 @@ XojPageView::XojPageView(XournalView* xournal, const PageRef& page) {
     g_mutex_init(&this->drawingMutex);
 
     g_mutex_init(&this->repaintRectMutex);
+    this->rerenderRegion = cairo_region_create();
 
     // this does not have to be deleted afterwards:
     // (we need it for undo commands)
@@ -76,6 +89,7 @@ XojPageView::~XojPageView() {
     delete this->eraser;
     endText();
     deleteViewBuffer();
+    cairo_region_destroy(this->rerenderRegion);
     delete this->search;
 }
 
@@ -103,9 +117,109 @@ void XojPageView::deleteViewBuffer() {
         cairo_surface_destroy(this->crBuffer);
         this->crBuffer = nullptr;
     }
+    this->crBufferDraft = false;
+    deleteLayerBuffers();
+    deleteZoomLevels();
+    g_mutex_unlock(&this->drawingMutex);
+}
+
+void XojPageView::deleteZoomLevels() {
+    for (auto const& level: this->zoomLevels) {
+        cairo_surface_destroy(level.second);
+    }
+    this->zoomLevels.clear();
+}
+
+auto XojPageView::getZoomLevel(cairo_surface_t* buffer) const -> int {
+    double zoom = cairo_image_surface_get_width(buffer) / this->page->getWidth();
+    return static_cast<int>(std::lround(std::log2(zoom)));
+}
+
+void XojPageView::replaceBuffer(cairo_surface_t* buffer) {
+    cairo_surface_t* old = this->crBuffer;
+    this->crBuffer = buffer;
+
+    if (old == nullptr) {
+        return;
+    }
+
+    if (this->crBufferDraft || cairo_image_surface_get_width(old) == cairo_image_surface_get_width(buffer)) {
+        // Not rendered because of a zoom change, the zoom levels may show an old state of the page
+        cairo_surface_destroy(old);
+        deleteZoomLevels();
+    } else {
+        // Zooming back in is smooth, but only two levels above the current zoom are kept
+        int current = getZoomLevel(buffer);
+        int level = getZoomLevel(old);
+        if (level > current) {
+            std::swap(this->zoomLevels[level], old);
+        }
+        if (old) {
+            cairo_surface_destroy(old);
+        }
+
+        for (auto it = this->zoomLevels.begin(); it != this->zoomLevels.end();) {
+            if (it->first == current || it->first > current + MAX_UPPER_ZOOM_LEVELS) {
+                cairo_surface_destroy(it->second);
+                it = this->zoomLevels.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    this->crBufferDraft = false;
+}
+
+void XojPageView::createZoomLevels() {
+    g_mutex_lock(&this->drawingMutex);
+
+    if (this->crBuffer == nullptr || this->crBufferDraft) {
+        g_mutex_unlock(&this->drawingMutex);
+        return;
+    }
+
+    int current = getZoomLevel(this->crBuffer);
+    for (auto it = this->zoomLevels.begin(); it != this->zoomLevels.end() && it->first <= current;) {
+        cairo_surface_destroy(it->second);
+        it = this->zoomLevels.erase(it);
+    }
+
+    // Each level halves the size of the one above, so zooming out is not aliased
+    cairo_surface_t* source = this->crBuffer;
+    for (int i = 1; i <= MAX_LOWER_ZOOM_LEVELS; i++) {
+        int width = cairo_image_surface_get_width(source) / 2;
+        int height = cairo_image_surface_get_height(source) / 2;
+        if (width < MIN_ZOOM_LEVEL_SIZE || height < MIN_ZOOM_LEVEL_SIZE) {
+            break;
+        }
+
+        cairo_surface_t* level = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        cairo_t* cr = cairo_create(level);
+        cairo_scale(cr, 0.5, 0.5);
+        cairo_set_source_surface(cr, source, 0, 0);
+        cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+
+        this->zoomLevels[current - i] = level;
+        source = level;
+    }
+
     g_mutex_unlock(&this->drawingMutex);
 }
 
+void XojPageView::deleteLayerBuffers() {
+    if (this->belowLayersBuffer) {
+        cairo_surface_destroy(this->belowLayersBuffer);
+        this->belowLayersBuffer = nullptr;
+    }
+    if (this->aboveLayersBuffer) {
+        cairo_surface_destroy(this->aboveLayersBuffer);
+        this->aboveLayersBuffer = nullptr;
+    }
+}
+
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
     if (!local) {
         bool leftOk = this->getX() <= x;
@@ -135,7 +249,7 @@ auto XojPageView::searchTextOnPage(string& text, int* occures, double* top) -> b
             pdf = doc->getPdfPage(pNr);
             doc->unlock();
         }
-        this->search = new SearchControl(page, pdf);
+        this->search = new SearchControl(page, pdf, xournal->getControl()->getSearchIndex());
     }
 
     bool found = this->search->search(text, occures, top);
@@ -620,38 +734,47 @@ void XojPageView::repaintArea(double x1, double y1, double x2, double y2) {
 }
 
 void XojPageView::rerenderRect(double x, double y, double width, double height) {
+    addPaddedRerenderRect(x, y, width, height, false);
+}
+
+void XojPageView::rerenderSelectedLayerRect(double x, double y, double width, double height) {
+    addPaddedRerenderRect(x, y, width, height, true);
+}
+
+void XojPageView::addPaddedRerenderRect(double x, double y, double width, double height, bool selectedLayerOnly) {
     int rx = std::lround(std::max(x - 10, 0.0));
     int ry = std::lround(std::max(y - 10, 0.0));
     int rwidth = std::lround(width + 20);
     int rheight = std::lround(height + 20);
 
-    addRerenderRect(rx, ry, rwidth, rheight);
+    addRerenderRect(rx, ry, rwidth, rheight, selectedLayerOnly);
 }
 
-void XojPageView::addRerenderRect(double x, double y, double width, double height) {
+void XojPageView::addRerenderRect(double x, double y, double width, double height, bool selectedLayerOnly) {
     if (this->rerenderComplete) {
         return;
     }
 
-    auto rect = Rectangle<double>{x, y, width, height};
+    int x1 = static_cast<int>(std::floor(x));
+    int y1 = static_cast<int>(std::floor(y));
+    cairo_rectangle_int_t rect = {x1, y1, static_cast<int>(std::ceil(x + width)) - x1,
+                                  static_cast<int>(std::ceil(y + height)) - y1};
 
     g_mutex_lock(&this->repaintRectMutex);
 
-    for (auto&& r: this->rerenderRects) {
-        // its faster to redraw only one rect than repaint twice the same area
-        // so loop through the rectangles to be redrawn, if new rectangle
-        // intersects any of them, replace it by the union with the new one
-        if (r.intersects(rect)) {
-            r.unite(rect);
-            g_mutex_unlock(&this->repaintRectMutex);
-            return;
-        }
+    if (!selectedLayerOnly) {
+        this->rerenderOtherLayers = true;
     }
 
-    this->rerenderRects.push_back(rect);
+    // All changes until the RenderJob runs are rendered together, it only needs to be scheduled once
+    bool scheduled = !cairo_region_is_empty(this->rerenderRegion);
+    cairo_region_union_rectangle(this->rerenderRegion, &rect);
+
     g_mutex_unlock(&this->repaintRectMutex);
 
-    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+    if (!scheduled) {
+        this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+    }
 }
 
 void XojPageView::setSelected(bool selected) {
@@ -742,15 +865,36 @@ void XojPageView::paintPageSync(cairo_t* cr, GdkRectangle* rect) {
     }
 
     if (width != dispWidth) {
+        // Paint the rendering closest to the current zoom, the nearer one on a tie is the larger one
+        cairo_surface_t* buffer = this->crBuffer;
+        double target = static_cast<double>(dispWidth) * xournal->getDpiScaleFactor();
+        double bestDistance = std::abs(std::log2(width / target));
+        for (auto const& level: this->zoomLevels) {
+            double levelWidth = cairo_image_surface_get_width(level.second);
+            double distance = std::abs(std::log2(levelWidth / target));
+            if (distance < bestDistance || (distance == bestDistance && levelWidth > width)) {
+                buffer = level.second;
+                bestDistance = distance;
+                width = levelWidth;
+            }
+        }
+
         double scale = (static_cast<double>(dispWidth)) / (width);
 
         // Scale current image to fit the zoom level
         cairo_scale(cr, scale, scale);
-        cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
 
-        cairo_set_source_surface(cr, this->crBuffer, 0, 0);
+        cairo_set_source_surface(cr, buffer, 0, 0);
+        cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_BILINEAR);
 
-        if (rerender) {
+        if (this->crBufferDraft) {
+            // Scheduled here and not by the RenderJob of the draft, so it is queued after the
+            // drafts of the other pages which became visible at the same time
+            if (!this->draftRerenderScheduled) {
+                this->draftRerenderScheduled = true;
+                rerenderPage();
+            }
+        } else if (rerender) {
             rerenderPage();
         }
 
@@ -819,10 +963,16 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
 auto XojPageView::isSelected() const -> bool { return selected; }
 
 auto XojPageView::getBufferPixels() -> int {
-    if (crBuffer) {
-        return cairo_image_surface_get_width(crBuffer) * cairo_image_surface_get_height(crBuffer);
+    int pixels = 0;
+    for (cairo_surface_t* buffer: {crBuffer, belowLayersBuffer, aboveLayersBuffer}) {
+        if (buffer) {
+            pixels += cairo_image_surface_get_width(buffer) * cairo_image_surface_get_height(buffer);
+        }
+    }
+    for (auto const& level: zoomLevels) {
+        pixels += cairo_image_surface_get_width(level.second) * cairo_image_surface_get_height(level.second);
     }
-    return 0;
+    return pixels;
 }
 
 auto XojPageView::getSelectionColor() -> GdkRGBA { return Util::rgb_to_GdkRGBA(settings->getSelectionColor()); }
@@ -914,6 +1064,9 @@ void XojPageView::elementChanged(Element* elem) {
         cairo_destroy(cr);
 
         g_mutex_unlock(&this->drawingMutex);
+    } else if (this->page->getSelectedLayer()->contains(elem)) {
+        rerenderSelectedLayerRect(elem->getX() - 1, elem->getY() - 1, elem->getElementWidth() + 2,
+                                  elem->getElementHeight() + 2);
     } else {
         rerenderElement(elem);
     }
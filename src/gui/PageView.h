@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <map>
+
 #include "gui/inputdevices/PositionInputData.h"
 #include "model/PageListener.h"
 #include "model/PageRef.h"
@@ -43,6 +45,11 @@ public:
     virtual void rerenderPage();
     virtual void rerenderRect(double x, double y, double width, double height);
 
+    /**
+     * Like rerenderRect(), but only the selected layer has changed in this area
+     */
+    void rerenderSelectedLayerRect(double x, double y, double width, double height);
+
     virtual void repaintPage();
     virtual void repaintArea(double x1, double y1, double x2, double y2);
 
@@ -69,6 +76,11 @@ public:
 
     void deleteViewBuffer();
 
+    /**
+     * Downscales the current rendering of the page into the lower zoom levels, called when a zoom sequence starts
+     */
+    void createZoomLevels();
+
     /**
      * Returns whether this PageView contains the
      * given point on the display
@@ -172,7 +184,29 @@ private:
 
     void startText(double x, double y);
 
-    void addRerenderRect(double x, double y, double width, double height);
+    /**
+     * Needs the drawingMutex
+     */
+    void deleteLayerBuffers();
+
+    /**
+     * Needs the drawingMutex
+     */
+    void deleteZoomLevels();
+
+    /**
+     * Replaces crBuffer with a complete rendering, the old buffer is kept as zoom level if it has a
+     * higher resolution. Needs the drawingMutex.
+     */
+    void replaceBuffer(cairo_surface_t* buffer);
+
+    /**
+     * Power of two bucket of the zoom a buffer was rendered with
+     */
+    int getZoomLevel(cairo_surface_t* buffer) const;
+
+    void addPaddedRerenderRect(double x, double y, double width, double height, bool selectedLayerOnly);
+    void addRerenderRect(double x, double y, double width, double height, bool selectedLayerOnly);
 
     void drawLoadingPage(cairo_t* cr);
 
@@ -208,6 +242,20 @@ private:
 
     cairo_surface_t* crBuffer = nullptr;
 
+    /**
+     * crBuffer only contains the low resolution draft of the page, and whether the complete rendering
+     * has been scheduled. Protected by drawingMutex.
+     */
+    bool crBufferDraft = false;
+    bool draftRerenderScheduled = false;
+
+    /**
+     * Renderings of the page at other zoom levels, by getZoomLevel(). The lower levels are downscaled from crBuffer
+     * when a zoom sequence starts, the higher levels are former crBuffers. The level closest to the current zoom is
+     * painted until the page is rendered again. Protected by drawingMutex.
+     */
+    std::map<int, cairo_surface_t*> zoomLevels;
+
     bool inEraser = false;
 
     /**
@@ -226,11 +274,34 @@ private:
     int lastVisibleTime = -1;
 
     GMutex repaintRectMutex{};
-    vector<Rectangle<double>> rerenderRects;
+
+    /**
+     * The changed areas since the last RenderJob took them, in page coordinates.
+     * A RenderJob is scheduled as long as the region is not empty.
+     */
+    cairo_region_t* rerenderRegion = nullptr;
     bool rerenderComplete = false;
 
+    /**
+     * The rerenderRegion contains changes outside of the selected layer
+     */
+    bool rerenderOtherLayers = false;
+
     GMutex drawingMutex{};
 
+    /**
+     * The background and the visible layers below the selected layer, and the visible layers above it,
+     * rendered at the size of crBuffer. Used by the RenderJob, so a change of the selected layer only
+     * needs to redraw this one layer. Protected by drawingMutex.
+     */
+    cairo_surface_t* belowLayersBuffer = nullptr;
+    cairo_surface_t* aboveLayersBuffer = nullptr;
+
+    /**
+     * Zoom, selected layer and layer visibility the layer buffers were rendered with
+     */
+    string layerBuffersKey;
+
     int dispX{};  // position on display - set in Layout::layoutPages
     int dispY{};
 
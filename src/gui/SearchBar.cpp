@@ -41,9 +41,14 @@ SearchBar::SearchBar(Control* control): control(control) {
     cssTextFild = gtk_css_provider_new();
     gtk_style_context_add_provider(gtk_widget_get_style_context(win->get("searchTextField")),
                                    GTK_STYLE_PROVIDER(cssTextFild), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+
+    control->getSearchIndex()->setListener(this);
 }
 
-SearchBar::~SearchBar() { this->control = nullptr; }
+SearchBar::~SearchBar() {
+    this->control->getSearchIndex()->setListener(nullptr);
+    this->control = nullptr;
+}
 
 auto SearchBar::searchTextonCurrentPage(const char* text, int* occures, double* top) -> bool {
     int p = control->getCurrentPageNo();
@@ -52,9 +57,6 @@ auto SearchBar::searchTextonCurrentPage(const char* text, int* occures, double*
 }
 
 void SearchBar::search(const char* text) {
-    MainWindow* win = control->getWindow();
-    GtkWidget* lbSearchState = win->get("lbSearchState");
-
     bool found = true;
     int occures = 0;
 
@@ -62,27 +64,76 @@ void SearchBar::search(const char* text) {
         found = searchTextonCurrentPage(text, &occures, nullptr);
         if (found) {
             if (occures == 1) {
-                gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text found on this page"));
+                this->pageState = _("Text found on this page");
             } else {
-                char* msg = g_strdup_printf(_("Text %i times found on this page"), occures);
-                gtk_label_set_text(GTK_LABEL(lbSearchState), msg);
-                g_free(msg);
+                this->pageState = FS(_F("Text {1} times found on this page") % occures);
             }
         } else {
-            gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found"));
+            this->pageState = _("Text not found");
         }
     } else {
         searchTextonCurrentPage("", nullptr, nullptr);
-        gtk_label_set_text(GTK_LABEL(lbSearchState), "");
+        this->pageState = "";
+    }
+
+    this->pageFound = found;
+    updateDocumentResults();
+}
+
+void SearchBar::updateDocumentResults() {
+    MainWindow* win = control->getWindow();
+    GtkWidget* searchTextField = win->get("searchTextField");
+    const char* text = gtk_entry_get_text(GTK_ENTRY(searchTextField));
+
+    this->documentMatches.clear();
+    if (*text == 0) {
+        setSearchState(this->pageState);
+        return;
     }
 
-    if (found) {
+    bool complete = control->getSearchIndex()->search(text, this->documentMatches);
+
+    int total = 0;
+    int pages = 0;
+    for (int matches: this->documentMatches) {
+        if (matches > 0) {
+            total += matches;
+            pages++;
+        }
+    }
+
+    string state = this->pageState;
+    if (total > 0) {
+        state += " - ";
+        state += FS(_F("{1} times found on {2} pages") % total % pages);
+    }
+    if (!complete) {
+        state += " - ";
+        state += _("indexing...");
+    }
+
+    setSearchState(state);
+
+    if (this->pageFound || total > 0) {
         gtk_css_provider_load_from_data(cssTextFild, "GtkSearchEntry {}", -1, nullptr);
     } else {
         gtk_css_provider_load_from_data(cssTextFild, "GtkSearchEntry { color: #ff0000; }", -1, nullptr);
     }
 }
 
+void SearchBar::setSearchState(const string& state) {
+    GtkWidget* lbSearchState = control->getWindow()->get("lbSearchState");
+    gtk_label_set_text(GTK_LABEL(lbSearchState), state.c_str());
+}
+
+void SearchBar::searchIndexUpdated() {
+    if (!gtk_widget_get_visible(control->getWindow()->get("searchBar"))) {
+        return;
+    }
+
+    updateDocumentResults();
+}
+
 void SearchBar::searchTextChangedCallback(GtkEntry* entry, SearchBar* searchBar) {
     const char* text = gtk_entry_get_text(entry);
     searchBar->search(text);
@@ -102,11 +153,13 @@ void SearchBar::searchNext() {
     int x = page + 1;
     GtkWidget* searchTextField = win->get("searchTextField");
     const char* text = gtk_entry_get_text(GTK_ENTRY(searchTextField));
-    GtkWidget* lbSearchState = win->get("lbSearchState");
     if (*text == 0) {
         return;
     }
 
+    // The index may have changed since the last update
+    control->getSearchIndex()->search(text, this->documentMatches);
+
     if (x >= count) {
         x = 0;
     }
@@ -115,13 +168,16 @@ void SearchBar::searchNext() {
     int occures = 0;
 
     while (x != page) {
+        // Pages without any match according to the index don't need to be searched
+        bool skip = x < static_cast<int>(this->documentMatches.size()) && this->documentMatches[x] == 0;
 
-        bool found = control->searchTextOnPage(text, x, &occures, &top);
+        bool found = !skip && control->searchTextOnPage(text, x, &occures, &top);
         if (found) {
             control->getScrollHandler()->scrollToPage(x, top);
-            gtk_label_set_text(GTK_LABEL(lbSearchState),
-                               (occures == 1 ? FC(_F("Text found once on page {1}") % (x + 1)) :
-                                               FC(_F("Text found {1} times on page {2}") % occures % (x + 1))));
+            this->pageState = (occures == 1 ? FS(_F("Text found once on page {1}") % (x + 1)) :
+                                              FS(_F("Text found {1} times on page {2}") % occures % (x + 1)));
+            this->pageFound = true;
+            updateDocumentResults();
             return;
         }
 
@@ -131,7 +187,9 @@ void SearchBar::searchNext() {
         }
     }
 
-    gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found, searched on all pages"));
+    this->pageState = _("Text not found, searched on all pages");
+    this->pageFound = false;
+    updateDocumentResults();
 }
 
 void SearchBar::searchPrevious() {
@@ -146,11 +204,13 @@ void SearchBar::searchPrevious() {
     int x = page - 1;
     GtkWidget* searchTextField = win->get("searchTextField");
     const char* text = gtk_entry_get_text(GTK_ENTRY(searchTextField));
-    GtkWidget* lbSearchState = win->get("lbSearchState");
     if (*text == 0) {
         return;
     }
 
+    // The index may have changed since the last update
+    control->getSearchIndex()->search(text, this->documentMatches);
+
     if (x < 0) {
         x = count - 1;
     }
@@ -159,13 +219,16 @@ void SearchBar::searchPrevious() {
     int occures = 0;
 
     while (x != page) {
+        // Pages without any match according to the index don't need to be searched
+        bool skip = x < static_cast<int>(this->documentMatches.size()) && this->documentMatches[x] == 0;
 
-        bool found = control->searchTextOnPage(text, x, &occures, &top);
+        bool found = !skip && control->searchTextOnPage(text, x, &occures, &top);
         if (found) {
             control->getScrollHandler()->scrollToPage(x, top);
-            gtk_label_set_text(GTK_LABEL(lbSearchState),
-                               (occures == 1 ? FC(_F("Text found once on page {1}") % (x + 1)) :
-                                               FC(_F("Text found {1} times on page {2}") % occures % (x + 1))));
+            this->pageState = (occures == 1 ? FS(_F("Text found once on page {1}") % (x + 1)) :
+                                              FS(_F("Text found {1} times on page {2}") % occures % (x + 1)));
+            this->pageFound = true;
+            updateDocumentResults();
             return;
         }
 
@@ -175,7 +238,9 @@ void SearchBar::searchPrevious() {
         }
     }
 
-    gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found, searched on all pages"));
+    this->pageState = _("Text not found, searched on all pages");
+    this->pageFound = false;
+    updateDocumentResults();
 }
 
 void SearchBar::showSearchBar(bool show) {
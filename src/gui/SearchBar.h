@@ -16,17 +16,23 @@
 
 #include <gtk/gtk.h>
 
+#include "control/SearchIndex.h"
+
 #include "XournalType.h"
 
 class Control;
 
-class SearchBar {
+class SearchBar: public SearchIndexListener {
 public:
     SearchBar(Control* control);
     virtual ~SearchBar();
 
     void showSearchBar(bool show);
 
+public:
+    // SearchIndexListener interface
+    void searchIndexUpdated() override;
+
 private:
     static void buttonCloseSearchClicked(GtkButton* button, SearchBar* searchBar);
     static void searchTextChangedCallback(GtkEntry* entry, SearchBar* searchBar);
@@ -40,7 +46,24 @@ private:
     void search(const char* text);
     bool searchTextonCurrentPage(const char* text, int* occures, double* top);
 
+    /**
+     * Updates the matches of the whole document from the search index
+     */
+    void updateDocumentResults();
+    void setSearchState(const string& state);
+
 private:
     Control* control;
     GtkCssProvider* cssTextFild;
+
+    /**
+     * The search result of the current page / of the last next / previous search
+     */
+    string pageState;
+    bool pageFound = true;
+
+    /**
+     * Number of matches per page, -1 if the page is not indexed yet
+     */
+    vector<int> documentMatches;
 };
@@ -15,6 +15,7 @@
 #include "undo/DeleteUndoAction.h"
 #include "widgets/XournalWidget.h"
 
+#include "InkLatency.h"
 #include "Layout.h"
 #include "PageView.h"
 #include "Rectangle.h"
@@ -48,6 +49,10 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
     this->repaintHandler = new RepaintHandler(this);
     this->handRecognition = new HandRecognition(this->widget, inputContext, control->getSettings());
 
+    if (control->getSettings()->getInkLatencyOverlay()) {
+        this->inkLatency = new InkLatency(this->widget, scrollHandling);
+    }
+
     control->getZoomControl()->addZoomListener(this);
 
     gtk_widget_set_can_default(this->widget, true);
@@ -71,6 +76,12 @@ XournalView::~XournalView() {
     delete this->repaintHandler;
     this->repaintHandler = nullptr;
 
+    if (this->inkLatency) {
+        this->inkLatency->dump();
+        delete this->inkLatency;
+        this->inkLatency = nullptr;
+    }
+
     gtk_widget_destroy(this->widget);
     this->widget = nullptr;
 
@@ -348,6 +359,14 @@ auto XournalView::getViewFor(size_t pageNr) -> XojPageView* {
     return this->viewPages[pageNr];
 }
 
+void XournalView::createZoomLevels() {
+    for (XojPageView* v: this->viewPages) {
+        if (v->getLastVisibleTime() == 0) {
+            v->createZoomLevels();
+        }
+    }
+}
+
 void XournalView::pageSelected(size_t page) {
     if (this->currentPage == page && this->lastSelectedPage == page) {
         return;
@@ -471,6 +490,8 @@ auto XournalView::getVisibleRect(XojPageView* redrawable) -> Rectangle<double>*
  */
 auto XournalView::getHandRecognition() -> HandRecognition* { return handRecognition; }
 
+auto XournalView::getInkLatency() -> InkLatency* { return inkLatency; }
+
 /**
  * @return Scrollbars
  */
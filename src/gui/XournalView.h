@@ -30,6 +30,7 @@ class RepaintHandler;
 class ScrollHandling;
 class TextEditor;
 class HandRecognition;
+class InkLatency;
 
 class XournalView: public DocumentListener, public ZoomListener {
 public:
@@ -61,6 +62,11 @@ public:
 
     XojPageView* getViewFor(size_t pageNr);
 
+    /**
+     * Prepares the downscaled renderings of the visible pages, for smooth zooming
+     */
+    void createZoomLevels();
+
     bool searchTextOnPage(string text, size_t p, int* occures, double* top);
 
     bool cut();
@@ -113,6 +119,11 @@ public:
      */
     HandRecognition* getHandRecognition();
 
+    /**
+     * @return The ink latency measurement, nullptr if it is disabled
+     */
+    InkLatency* getInkLatency();
+
     /**
      * @return Scrollbars
      */
@@ -181,5 +192,10 @@ private:
      */
     HandRecognition* handRecognition = nullptr;
 
+    /**
+     * Only created if the setting "inkLatencyOverlay" is enabled
+     */
+    InkLatency* inkLatency = nullptr;
+
     friend class Layout;
 };
@@ -346,6 +346,7 @@ void SettingsDialog::load() {
     loadCheckbox("cbTrySelectOnStrokeFiltered", settings->getTrySelectOnStrokeFiltered());
     loadCheckbox("cbSnapRecognizedShapesEnabled", settings->getSnapRecognizedShapesEnabled());
     loadCheckbox("cbRestoreLineWidthEnabled", settings->getRestoreLineWidthEnabled());
+    loadCheckbox("cbStrokeSimplificationEnabled", settings->getStrokeSimplificationEnabled());
     loadCheckbox("cbDarkTheme", settings->isDarkTheme());
     loadCheckbox("cbHideHorizontalScrollbar", settings->getScrollbarHideType() & SCROLLBAR_HIDE_HORIZONTAL);
     loadCheckbox("cbHideVerticalScrollbar", settings->getScrollbarHideType() & SCROLLBAR_HIDE_VERTICAL);
@@ -369,6 +370,9 @@ void SettingsDialog::load() {
     GtkWidget* spAutosaveTimeout = get("spAutosaveTimeout");
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(spAutosaveTimeout), settings->getAutosaveTimeout());
 
+    GtkWidget* spSaveCompressionLevel = get("spSaveCompressionLevel");
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(spSaveCompressionLevel), settings->getSaveCompressionLevel());
+
     GtkWidget* spNumIgnoredStylusEvents = get("spNumIgnoredStylusEvents");
     if (!ignoreStylusEventsEnabled) {  // The spinButton's value should be >= 1
         gtk_spin_button_set_value(GTK_SPIN_BUTTON(spNumIgnoredStylusEvents), 1);
@@ -409,6 +413,10 @@ void SettingsDialog::load() {
     GtkWidget* spTouchZoomStartThreshold = get("spTouchZoomStartThreshold");
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(spTouchZoomStartThreshold), settings->getTouchZoomStartThreshold());
 
+    GtkWidget* spStrokeSimplificationTolerance = get("spStrokeSimplificationTolerance");
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(spStrokeSimplificationTolerance),
+                              settings->getStrokeSimplificationTolerance());
+
     {
         int time = 0;
         double length = 0;
@@ -641,6 +649,7 @@ void SettingsDialog::save() {
     settings->setTrySelectOnStrokeFiltered(getCheckbox("cbTrySelectOnStrokeFiltered"));
     settings->setSnapRecognizedShapesEnabled(getCheckbox("cbSnapRecognizedShapesEnabled"));
     settings->setRestoreLineWidthEnabled(getCheckbox("cbRestoreLineWidthEnabled"));
+    settings->setStrokeSimplificationEnabled(getCheckbox("cbStrokeSimplificationEnabled"));
     settings->setDarkTheme(getCheckbox("cbDarkTheme"));
     settings->setPressureGuessingEnabled(getCheckbox("cbEnablePressureInference"));
     settings->setTouchWorkaround(getCheckbox("cbTouchWorkaround"));
@@ -718,6 +727,9 @@ void SettingsDialog::save() {
     int autosaveTimeout = gtk_spin_button_get_value(GTK_SPIN_BUTTON(spAutosaveTimeout));
     settings->setAutosaveTimeout(autosaveTimeout);
 
+    GtkWidget* spSaveCompressionLevel = get("spSaveCompressionLevel");
+    settings->setSaveCompressionLevel(gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spSaveCompressionLevel)));
+
     if (getCheckbox("cbIgnoreFirstStylusEvents")) {
         GtkWidget* spNumIgnoredStylusEvents = get("spNumIgnoredStylusEvents");
         int numIgnoredStylusEvents = gtk_spin_button_get_value(GTK_SPIN_BUTTON(spNumIgnoredStylusEvents));
@@ -759,6 +771,10 @@ void SettingsDialog::save() {
     int strokeSuccessiveTime = gtk_spin_button_get_value(GTK_SPIN_BUTTON(spStrokeSuccessiveTime));
     settings->setStrokeFilter(strokeIgnoreTime, strokeIgnoreLength, strokeSuccessiveTime);
 
+    GtkWidget* spStrokeSimplificationTolerance = get("spStrokeSimplificationTolerance");
+    settings->setStrokeSimplificationTolerance(
+            gtk_spin_button_get_value(GTK_SPIN_BUTTON(spStrokeSimplificationTolerance)));
+
     GtkWidget* spTouchZoomStartThreshold = get("spTouchZoomStartThreshold");
     double zoomStartThreshold = gtk_spin_button_get_value(GTK_SPIN_BUTTON(spTouchZoomStartThreshold));
     settings->setTouchZoomStartThreshold(zoomStartThreshold);
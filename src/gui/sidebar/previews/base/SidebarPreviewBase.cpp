@@ -1,11 +1,18 @@
 #include "SidebarPreviewBase.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 #include "control/Control.h"
 #include "control/PdfCache.h"
 
 #include "SidebarLayout.h"
 #include "SidebarPreviewBaseEntry.h"
 
+/**
+ * Queued previews further away from the visible area than this many screens are dropped
+ */
+constexpr double const PREVIEW_PREFETCH_SCREENS = 1.0;
 
 SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarToolbar* toolbar):
         AbstractSidebarPage(control, toolbar) {
@@ -31,6 +38,10 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarT
     registerListener(this->control);
 
     g_signal_connect(this->scrollPreview, "size-allocate", G_CALLBACK(sizeChanged), this);
+    g_signal_connect(gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview)), "value-changed",
+                     G_CALLBACK(scrollChanged), this);
+    g_signal_connect(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview)), "value-changed",
+                     G_CALLBACK(scrollChanged), this);
 
     gtk_widget_show_all(this->scrollPreview);
 
@@ -38,6 +49,11 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarT
 }
 
 SidebarPreviewBase::~SidebarPreviewBase() {
+    g_signal_handlers_disconnect_by_data(gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview)),
+                                         this);
+    g_signal_handlers_disconnect_by_data(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview)),
+                                         this);
+
     gtk_widget_destroy(this->iconViewPreview);
     this->iconViewPreview = nullptr;
 
@@ -72,6 +88,45 @@ void SidebarPreviewBase::sizeChanged(GtkWidget* widget, GtkAllocation* allocatio
     }
 }
 
+void SidebarPreviewBase::scrollChanged(GtkAdjustment* adjustment, SidebarPreviewBase* sidebar) {
+    sidebar->rankPreviews();
+}
+
+void SidebarPreviewBase::rankPreviews() {
+    GtkAdjustment* hadj = gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    double visX = gtk_adjustment_get_value(hadj);
+    double visY = gtk_adjustment_get_value(vadj);
+    double visWidth = gtk_adjustment_get_page_size(hadj);
+    double visHeight = gtk_adjustment_get_page_size(vadj);
+    if (visWidth <= 0 || visHeight <= 0) {
+        // Not shown yet
+        return;
+    }
+
+    // The allocation is read here, the distance is requested while the scheduler queue is locked
+    std::unordered_map<SidebarPreviewBaseEntry*, double> distances;
+    for (SidebarPreviewBaseEntry* p: this->previews) {
+        GtkAllocation r;
+        gtk_widget_get_allocation(p->getWidget(), &r);
+        if (r.x == -1) {
+            continue;
+        }
+
+        double dx = std::max({0.0, r.x - (visX + visWidth), visX - (r.x + r.width)});
+        double dy = std::max({0.0, r.y - (visY + visHeight), visY - (r.y + r.height)});
+        distances[p] = dx + dy;
+    }
+
+    // Previews of the other sidebar pages, or which are not placed yet, are treated as visible
+    auto distance = [&distances](SidebarPreviewBaseEntry* p) {
+        auto it = distances.find(p);
+        return it == distances.end() ? 0.0 : it->second;
+    };
+    double prefetch = PREVIEW_PREFETCH_SCREENS * std::max(visWidth, visHeight);
+    this->control->getScheduler()->rankPreviewJobs(distance, prefetch);
+}
+
 auto SidebarPreviewBase::getZoom() const -> double { return this->zoom; }
 
 auto SidebarPreviewBase::getCache() -> PdfCache* { return this->cache; }
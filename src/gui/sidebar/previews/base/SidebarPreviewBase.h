@@ -82,6 +82,16 @@ protected:
      */
     static void sizeChanged(GtkWidget* widget, GtkAllocation* allocation, SidebarPreviewBase* sidebar);
 
+    /**
+     * The previews were scrolled
+     */
+    static void scrollChanged(GtkAdjustment* adjustment, SidebarPreviewBase* sidebar);
+
+    /**
+     * Renders the previews closest to the visible area first, and drops the queued previews scrolled far away
+     */
+    void rankPreviews();
+
 private:
     /**
      * The scrollbar with the icons
@@ -57,6 +57,15 @@ void SidebarPreviewBaseEntry::setSelected(bool selected) {
 
 void SidebarPreviewBaseEntry::repaint() { sidebar->getControl()->getScheduler()->addRepaintSidebar(this); }
 
+void SidebarPreviewBaseEntry::deleteBuffer() {
+    g_mutex_lock(&this->drawingMutex);
+    if (this->crBuffer) {
+        cairo_surface_destroy(this->crBuffer);
+        this->crBuffer = nullptr;
+    }
+    g_mutex_unlock(&this->drawingMutex);
+}
+
 void SidebarPreviewBaseEntry::drawLoadingPage() {
     GtkAllocation alloc;
     gtk_widget_get_allocation(widget, &alloc);
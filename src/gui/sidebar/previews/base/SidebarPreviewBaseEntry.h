@@ -51,6 +51,11 @@ public:
     virtual void repaint();
     virtual void updateSize();
 
+    /**
+     * Frees the rendered preview, it is rendered again when it is painted
+     */
+    void deleteBuffer();
+
     /**
      * @return What should be rendered
      */
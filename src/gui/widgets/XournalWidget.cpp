@@ -9,6 +9,7 @@
 #include "control/Control.h"
 #include "control/settings/Settings.h"
 #include "control/tools/EditSelection.h"
+#include "gui/InkLatency.h"
 #include "gui/Layout.h"
 #include "gui/Shadow.h"
 #include "gui/XournalView.h"
@@ -281,6 +282,10 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
 
     cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
 
+    // The overlay is drawn in widget coordinates
+    cairo_matrix_t widgetMatrix;
+    cairo_get_matrix(cr, &widgetMatrix);
+
     // Draw background
     Settings* settings = xournal->view->getControl()->getSettings();
     Util::cairo_set_source_rgbi(cr, settings->getBackgroundColor());
@@ -319,6 +324,11 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
         xournal->selection->paint(cr, zoom);
     }
 
+    if (InkLatency* latency = xournal->view->getInkLatency()) {
+        cairo_set_matrix(cr, &widgetMatrix);
+        latency->drawOverlay(cr);
+    }
+
     return true;
 }
 
@@ -1,5 +1,6 @@
 #include "Image.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "serializing/ObjectInputStream.h"
@@ -25,6 +26,7 @@ auto Image::clone() -> Element* {
     img->width = this->width;
     img->height = this->height;
     img->data = this->data;
+    img->pngHash = this->pngHash;
 
     img->image = cairo_surface_reference(this->image);
     img->calcSize();
@@ -43,14 +45,19 @@ void Image::setHeight(double height) {
 }
 
 auto Image::cairoReadFunction(Image* image, unsigned char* data, unsigned int length) -> cairo_status_t {
-    for (unsigned int i = 0; i < length; i++, image->read++) {
-        if (image->read >= image->data.length()) {
-            return CAIRO_STATUS_READ_ERROR;
-        }
-
-        data[i] = image->data[image->read];
+    const string& png = *image->data;
+    if (image->read + length > png.length()) {
+        return CAIRO_STATUS_READ_ERROR;
     }
 
+    std::copy_n(png.begin() + image->read, length, data);
+    image->read += length;
+
+    return CAIRO_STATUS_SUCCESS;
+}
+
+auto Image::cairoWriteFunction(string* data, const unsigned char* buffer, unsigned int length) -> cairo_status_t {
+    data->append(reinterpret_cast<const char*>(buffer), length);
     return CAIRO_STATUS_SUCCESS;
 }
 
@@ -59,7 +66,20 @@ void Image::setImage(string data) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
     }
-    this->data = std::move(data);
+    this->data = std::make_shared<const string>(std::move(data));
+    this->pngHash.clear();
+}
+
+void Image::shareImage(Image* other) {
+    if (this->image) {
+        cairo_surface_destroy(this->image);
+        this->image = nullptr;
+    }
+    if (other->image) {
+        this->image = cairo_surface_reference(other->image);
+    }
+    this->data = other->data;
+    this->pngHash = other->pngHash;
 }
 
 void Image::setImage(GdkPixbuf* img) { setImage(f_pixbuf_to_cairo_surface(img)); }
@@ -71,10 +91,12 @@ void Image::setImage(cairo_surface_t* image) {
     }
 
     this->image = image;
+    this->data.reset();
+    this->pngHash.clear();
 }
 
 auto Image::getImage() -> cairo_surface_t* {
-    if (this->image == nullptr && this->data.length()) {
+    if (this->image == nullptr && this->data && !this->data->empty()) {
         this->read = 0;
         this->image = cairo_image_surface_create_from_png_stream(
                 reinterpret_cast<cairo_read_func_t>(&cairoReadFunction), this);
@@ -83,6 +105,31 @@ auto Image::getImage() -> cairo_surface_t* {
     return this->image;
 }
 
+auto Image::getPngData() -> std::shared_ptr<const string> {
+    if (!this->data) {
+        auto png = std::make_shared<string>();
+        if (this->image) {
+            cairo_surface_write_to_png_stream(this->image, reinterpret_cast<cairo_write_func_t>(&cairoWriteFunction),
+                                              png.get());
+        }
+        this->data = std::move(png);
+    }
+
+    return this->data;
+}
+
+auto Image::getPngHash() -> const string& {
+    if (this->pngHash.empty()) {
+        std::shared_ptr<const string> png = getPngData();
+        gchar* hash = g_compute_checksum_for_data(G_CHECKSUM_SHA1, reinterpret_cast<const guchar*>(png->data()),
+                                                  png->size());
+        this->pngHash = hash;
+        g_free(hash);
+    }
+
+    return this->pngHash;
+}
+
 void Image::scale(double x0, double y0, double fx, double fy, double rotation,
                   bool) {  // line width scaling option is not used
     this->x -= x0;
@@ -126,6 +173,8 @@ void Image::readSerialized(ObjectInputStream& in) {
     }
 
     this->image = in.readImage();
+    this->data.reset();
+    this->pngHash.clear();
 
     in.endObject();
     this->calcSize();
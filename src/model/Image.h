@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,21 @@ public:
     void setImage(GdkPixbuf* img);
     cairo_surface_t* getImage();
 
+    /**
+     * Shares the data of another image, which is loaded from the same PNG data
+     */
+    void shareImage(Image* other);
+
+    /**
+     * @return The PNG encoded image. It is only encoded once, images loaded from a file keep the file data.
+     */
+    std::shared_ptr<const string> getPngData();
+
+    /**
+     * @return SHA-1 of the PNG data, identical images are only stored once in a file
+     */
+    const string& getPngHash();
+
     virtual void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth);
     virtual void rotate(double x0, double y0, double th);
 
@@ -48,11 +64,16 @@ private:
     void calcSize() const override;
 
     static cairo_status_t cairoReadFunction(Image* image, unsigned char* data, unsigned int length);
+    static cairo_status_t cairoWriteFunction(string* data, const unsigned char* buffer, unsigned int length);
 
 private:
     cairo_surface_t* image = nullptr;
 
-    string data;
+    /**
+     * PNG data, shared between the copies of an image
+     */
+    std::shared_ptr<const string> data;
+    string pngHash;
 
     string::size_type read = false;
 };
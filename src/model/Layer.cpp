@@ -1,5 +1,8 @@
 #include "Layer.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "Stacktrace.h"
 
 Layer::Layer() = default;
@@ -14,6 +17,7 @@ Layer::~Layer() {
 auto Layer::clone() -> Layer* {
     auto* layer = new Layer();
 
+    layer->elements.reserve(this->elements.size());
     for (Element* e: this->elements) {
         layer->addElement(e->clone());
     }
@@ -21,6 +25,8 @@ auto Layer::clone() -> Layer* {
     return layer;
 }
 
+void Layer::invalidateIndex(ElementIndex from) { this->firstStaleIndex = std::min(this->firstStaleIndex, from); }
+
 void Layer::addElement(Element* e) {
     if (e == nullptr) {
         g_warning("addElement(nullptr)!");
@@ -28,13 +34,15 @@ void Layer::addElement(Element* e) {
         return;
     }
 
-    for (Element* elem2: this->elements) {
-        if (e == elem2) {
-            g_warning("Layer::addElement: Element is already on this layer!");
-            return;
-        }
+    auto size = static_cast<ElementIndex>(this->elements.size());
+    if (!this->elementIndex.emplace(e, size).second) {
+        g_warning("Layer::addElement: Element is already on this layer!");
+        return;
     }
 
+    if (this->firstStaleIndex == size) {
+        this->firstStaleIndex++;
+    }
     this->elements.push_back(e);
 }
 
@@ -45,12 +53,10 @@ void Layer::insertElement(Element* e, ElementIndex pos) {
         return;
     }
 
-    for (Element* elem2: this->elements) {
-        if (e == elem2) {
-            g_warning("Layer::insertElement() try to add an element twice!");
-            Stacktrace::printStracktrace();
-            return;
-        }
+    if (contains(e)) {
+        g_warning("Layer::insertElement() try to add an element twice!");
+        Stacktrace::printStracktrace();
+        return;
     }
 
     // prevent crash, even if this never should happen,
@@ -60,38 +66,110 @@ void Layer::insertElement(Element* e, ElementIndex pos) {
     }
 
     // If the element should be inserted at the top
-    if (pos >= static_cast<int>(this->elements.size())) {
-        this->elements.push_back(e);
-    } else {
-        this->elements.insert(this->elements.begin() + pos, e);
+    if (pos >= static_cast<ElementIndex>(this->elements.size())) {
+        addElement(e);
+        return;
     }
+
+    this->elements.insert(this->elements.begin() + pos, e);
+    this->elementIndex[e] = pos;
+    invalidateIndex(pos);
+}
+
+void Layer::insertElements(const IndexedElements& elements) {
+    vector<Element*> merged;
+    merged.reserve(this->elements.size() + elements.size());
+
+    auto old = this->elements.begin();
+    ElementIndex firstChange = this->elements.size();
+    for (auto const& [e, index]: elements) {
+        if (e == nullptr || !this->elementIndex.emplace(e, InvalidElementIndex).second) {
+            g_warning("Layer::insertElements() try to add an element twice!");
+            Stacktrace::printStracktrace();
+            continue;
+        }
+
+        while (old != this->elements.end() &&
+               (index == InvalidElementIndex || static_cast<ElementIndex>(merged.size()) < index)) {
+            merged.push_back(*old++);
+        }
+
+        firstChange = std::min<ElementIndex>(firstChange, merged.size());
+        merged.push_back(e);
+    }
+    merged.insert(merged.end(), old, this->elements.end());
+
+    this->elements = std::move(merged);
+    invalidateIndex(firstChange);
 }
 
 auto Layer::indexOf(Element* e) -> ElementIndex {
-    for (unsigned int i = 0; i < this->elements.size(); i++) {
-        if (this->elements[i] == e) {
-            return i;
+    auto it = this->elementIndex.find(e);
+    if (it == this->elementIndex.end()) {
+        return InvalidElementIndex;
+    }
+
+    if (it->second == InvalidElementIndex || it->second >= this->firstStaleIndex) {
+        auto size = static_cast<ElementIndex>(this->elements.size());
+        for (ElementIndex i = this->firstStaleIndex; i < size; i++) {
+            this->elementIndex[this->elements[i]] = i;
         }
+        this->firstStaleIndex = size;
     }
 
-    return InvalidElementIndex;
+    return it->second;
 }
 
+auto Layer::contains(Element* e) const -> bool { return this->elementIndex.count(e) > 0; }
+
 auto Layer::removeElement(Element* e, bool free) -> ElementIndex {
-    for (unsigned int i = 0; i < this->elements.size(); i++) {
-        if (e == this->elements[i]) {
-            this->elements.erase(this->elements.begin() + i);
-
-            if (free) {
-                delete e;
-            }
-            return i;
+    ElementIndex pos = indexOf(e);
+    if (pos == InvalidElementIndex) {
+        g_warning("Could not remove element from layer, it's not on the layer!");
+        Stacktrace::printStracktrace();
+        return InvalidElementIndex;
+    }
+
+    this->elements.erase(this->elements.begin() + pos);
+    this->elementIndex.erase(e);
+    invalidateIndex(pos);
+
+    if (free) {
+        delete e;
+    }
+    return pos;
+}
+
+auto Layer::removeElements(const vector<Element*>& elements) -> IndexedElements {
+    std::unordered_set<Element*> toRemove;
+    toRemove.reserve(elements.size());
+    for (Element* e: elements) {
+        if (this->elementIndex.erase(e) > 0) {
+            toRemove.insert(e);
+        } else {
+            g_warning("Could not remove element from layer, it's not on the layer!");
+            Stacktrace::printStracktrace();
+        }
+    }
+
+    IndexedElements removed;
+    if (toRemove.empty()) {
+        return removed;
+    }
+    removed.reserve(toRemove.size());
+
+    auto out = this->elements.begin();
+    for (auto it = this->elements.begin(); it != this->elements.end(); ++it) {
+        if (toRemove.count(*it)) {
+            removed.emplace_back(*it, it - this->elements.begin());
+        } else {
+            *out++ = *it;
         }
     }
+    this->elements.erase(out, this->elements.end());
 
-    g_warning("Could not remove element from layer, it's not on the layer!");
-    Stacktrace::printStracktrace();
-    return InvalidElementIndex;
+    invalidateIndex(removed.front().second);
+    return removed;
 }
 
 auto Layer::isAnnotated() -> bool { return !this->elements.empty(); }
@@ -12,6 +12,8 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Element.h"
@@ -26,6 +28,11 @@ public:
     using ElementIndex = std::ptrdiff_t;
     static constexpr auto InvalidElementIndex = static_cast<ElementIndex>(-1);
 
+    /**
+     * Elements with their index in the Layer, sorted by the index
+     */
+    using IndexedElements = vector<std::pair<Element*, ElementIndex>>;
+
 public:
     /**
      * Appends an Element to this Layer
@@ -41,18 +48,41 @@ public:
      */
     void insertElement(Element* e, ElementIndex pos);
 
+    /**
+     * Inserts many Element%s in one pass
+     *
+     * @param elements Sorted by the index, which is the position of the Element after the insertion.
+     *                 Elements with InvalidElementIndex are appended, they have to be at the end.
+     */
+    void insertElements(const IndexedElements& elements);
+
     /**
      * Returns the index of the given Element with respect to the internal list
      */
     ElementIndex indexOf(Element* e);
 
+    /**
+     * @return true if the Element is on this Layer, in constant time
+     */
+    bool contains(Element* e) const;
+
     /**
      * Removes an Element from the Layer and optionally deletes it
      */
     ElementIndex removeElement(Element* e, bool free);
 
+    /**
+     * Removes many Element%s in one pass, the Element%s are not deleted
+     *
+     * @return The removed Element%s with the index they had, sorted by the index.
+     *         Passing the result to insertElements() restores the Layer.
+     */
+    IndexedElements removeElements(const vector<Element*>& elements);
+
     /**
      * Returns an iterator over the Element%s contained in this Layer
+     *
+     * @note Do not modify the list, use the methods of the Layer
      */
     vector<Element*>* getElements();
 
@@ -76,8 +106,21 @@ public:
      */
     Layer* clone();
 
+private:
+    /**
+     * The indices from this position on need to be updated after an insertion or a removal
+     */
+    void invalidateIndex(ElementIndex from);
+
 private:
     vector<Element*> elements;
 
+    /**
+     * Index of each Element, also used to check the membership. The entries of the
+     * Elements from firstStaleIndex on are outdated and updated by indexOf().
+     */
+    std::unordered_map<Element*, ElementIndex> elementIndex;
+    ElementIndex firstStaleIndex = 0;
+
     bool visible = true;
 };
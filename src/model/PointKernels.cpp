@@ -0,0 +1,164 @@
+#include "PointKernels.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// x and y are loaded into one register
+static_assert(offsetof(Point, y) == offsetof(Point, x) + sizeof(double), "x and y of Point must be adjacent");
+
+namespace PointKernels {
+
+namespace Scalar {
+
+void transform(Point* points, size_t count, const cairo_matrix_t& matrix) {
+    for (size_t i = 0; i < count; i++) {
+        Point& p = points[i];
+        double x = p.x;
+        double y = p.y;
+        p.x = matrix.xx * x + matrix.xy * y + matrix.x0;
+        p.y = matrix.yx * x + matrix.yy * y + matrix.y0;
+    }
+}
+
+void translate(Point* points, size_t count, double dx, double dy) {
+    for (size_t i = 0; i < count; i++) {
+        points[i].x += dx;
+        points[i].y += dy;
+    }
+}
+
+void scalePressure(Point* points, size_t count, double factor) {
+    for (size_t i = 0; i < count; i++) {
+        if (points[i].z != Point::NO_PRESSURE) {
+            points[i].z *= factor;
+        }
+    }
+}
+
+void calcBounds(const Point* points, size_t count, double width, bool usePressure, Bounds& line, Bounds& snap) {
+    snap = {points[0].x, points[0].y, points[0].x, points[0].y};
+    line = snap;
+
+    double halfThick = width / 2.0;
+    for (size_t i = 0; i < count; i++) {
+        const Point& p = points[i];
+        if (usePressure) {
+            halfThick = p.z / 2.0;
+        }
+
+        line.x1 = std::min(line.x1, p.x - halfThick);
+        line.y1 = std::min(line.y1, p.y - halfThick);
+        line.x2 = std::max(line.x2, p.x + halfThick);
+        line.y2 = std::max(line.y2, p.y + halfThick);
+
+        snap.x1 = std::min(snap.x1, p.x);
+        snap.y1 = std::min(snap.y1, p.y);
+        snap.x2 = std::max(snap.x2, p.x);
+        snap.y2 = std::max(snap.y2, p.y);
+    }
+}
+
+}  // namespace Scalar
+
+#ifdef __SSE2__
+
+/*
+ * The lower lane of the registers holds x, the upper one y. Wider registers (AVX) do not help here: the points are
+ * 24 bytes apart, so two points do not fit into a register without shuffling, which costs the time gained.
+ */
+
+void transform(Point* points, size_t count, const cairo_matrix_t& matrix) {
+    const __m128d fromX = _mm_set_pd(matrix.yx, matrix.xx);
+    const __m128d fromY = _mm_set_pd(matrix.yy, matrix.xy);
+    const __m128d offset = _mm_set_pd(matrix.y0, matrix.x0);
+
+    for (size_t i = 0; i < count; i++) {
+        __m128d p = _mm_loadu_pd(&points[i].x);
+        __m128d x = _mm_unpacklo_pd(p, p);
+        __m128d y = _mm_unpackhi_pd(p, p);
+
+        // Same order of operations as the scalar version, so the results are identical
+        p = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, fromX), _mm_mul_pd(y, fromY)), offset);
+        _mm_storeu_pd(&points[i].x, p);
+    }
+}
+
+void translate(Point* points, size_t count, double dx, double dy) {
+    const __m128d offset = _mm_set_pd(dy, dx);
+
+    for (size_t i = 0; i < count; i++) {
+        _mm_storeu_pd(&points[i].x, _mm_add_pd(_mm_loadu_pd(&points[i].x), offset));
+    }
+}
+
+void scalePressure(Point* points, size_t count, double factor) {
+    const __m128d f = _mm_set1_pd(factor);
+    const __m128d noPressure = _mm_set1_pd(Point::NO_PRESSURE);
+
+    // Two points per iteration, the pressure values are gathered into one register
+    size_t i = 0;
+    for (; i + 1 < count; i += 2) {
+        __m128d z = _mm_loadh_pd(_mm_load_sd(&points[i].z), &points[i + 1].z);
+        __m128d keep = _mm_cmpeq_pd(z, noPressure);
+        z = _mm_or_pd(_mm_and_pd(keep, z), _mm_andnot_pd(keep, _mm_mul_pd(z, f)));
+
+        _mm_storel_pd(&points[i].z, z);
+        _mm_storeh_pd(&points[i + 1].z, z);
+    }
+
+    Scalar::scalePressure(points + i, count - i, factor);
+}
+
+void calcBounds(const Point* points, size_t count, double width, bool usePressure, Bounds& line, Bounds& snap) {
+    __m128d snapMin = _mm_loadu_pd(&points[0].x);
+    __m128d snapMax = snapMin;
+    __m128d lineMin = snapMin;
+    __m128d lineMax = snapMin;
+
+    const __m128d half = _mm_set1_pd(0.5);
+    __m128d halfThick = _mm_set1_pd(width / 2.0);
+
+    for (size_t i = 0; i < count; i++) {
+        __m128d p = _mm_loadu_pd(&points[i].x);
+        if (usePressure) {
+            halfThick = _mm_mul_pd(_mm_set1_pd(points[i].z), half);
+        }
+
+        lineMin = _mm_min_pd(lineMin, _mm_sub_pd(p, halfThick));
+        lineMax = _mm_max_pd(lineMax, _mm_add_pd(p, halfThick));
+        snapMin = _mm_min_pd(snapMin, p);
+        snapMax = _mm_max_pd(snapMax, p);
+    }
+
+    _mm_storel_pd(&line.x1, lineMin);
+    _mm_storeh_pd(&line.y1, lineMin);
+    _mm_storel_pd(&line.x2, lineMax);
+    _mm_storeh_pd(&line.y2, lineMax);
+
+    _mm_storel_pd(&snap.x1, snapMin);
+    _mm_storeh_pd(&snap.y1, snapMin);
+    _mm_storel_pd(&snap.x2, snapMax);
+    _mm_storeh_pd(&snap.y2, snapMax);
+}
+
+#else
+
+void transform(Point* points, size_t count, const cairo_matrix_t& matrix) {
+    Scalar::transform(points, count, matrix);
+}
+
+void translate(Point* points, size_t count, double dx, double dy) { Scalar::translate(points, count, dx, dy); }
+
+void scalePressure(Point* points, size_t count, double factor) { Scalar::scalePressure(points, count, factor); }
+
+void calcBounds(const Point* points, size_t count, double width, bool usePressure, Bounds& line, Bounds& snap) {
+    Scalar::calcBounds(points, count, width, usePressure, line, snap);
+}
+
+#endif
+
+}  // namespace PointKernels
@@ -0,0 +1,65 @@
+/*
+ * Xournal++
+ *
+ * Transformations and bounds of point arrays
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <cairo.h>
+
+#include "Point.h"
+
+/**
+ * Loops over the points of strokes, which are run for every point of a selection when it is moved, scaled or
+ * rotated. Uses SSE2 if the compiler targets it, x and y of a point are processed in the two lanes of a register.
+ *
+ * The results are the same as the scalar implementation, which is used on other platforms.
+ */
+namespace PointKernels {
+
+struct Bounds {
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+};
+
+/**
+ * Applies the matrix to the x and y coordinates of the points, like cairo_matrix_transform_point()
+ */
+void transform(Point* points, size_t count, const cairo_matrix_t& matrix);
+
+void translate(Point* points, size_t count, double dx, double dy);
+
+/**
+ * Multiplies the pressure of the points, points without pressure are kept unchanged
+ */
+void scalePressure(Point* points, size_t count, double factor);
+
+/**
+ * Calculates the bounds of the points, and the bounds of the line around the points. The line width is the
+ * pressure of each point, or width if usePressure is false.
+ *
+ * count must not be 0
+ */
+void calcBounds(const Point* points, size_t count, double width, bool usePressure, Bounds& line, Bounds& snap);
+
+/**
+ * Reference implementation, used if SSE2 is not available
+ */
+namespace Scalar {
+void transform(Point* points, size_t count, const cairo_matrix_t& matrix);
+void translate(Point* points, size_t count, double dx, double dy);
+void scalePressure(Point* points, size_t count, double factor);
+void calcBounds(const Point* points, size_t count, double width, bool usePressure, Bounds& line, Bounds& snap);
+}  // namespace Scalar
+
+}  // namespace PointKernels
@@ -1,8 +1,11 @@
 #include "Stroke.h"
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <utility>
 
+#include "model/PointKernels.h"
 #include "serializing/ObjectInputStream.h"
 #include "serializing/ObjectOutputStream.h"
 
@@ -68,6 +71,7 @@ void Stroke::readSerialized(ObjectInputStream& in) {
     in.readData(reinterpret_cast<void**>(&p), &count);
     this->points = std::vector<Point>{p, p + count};
     g_free(p);
+    pointsChanged();
     this->lineStyle.readSerialized(in);
 
     in.endObject();
@@ -95,6 +99,11 @@ void Stroke::setWidth(double width) { this->width = width; }
 
 auto Stroke::getWidth() const -> double { return this->width; }
 
+void Stroke::pointsChanged() {
+    this->sizeCalculated = false;
+    this->boundsTree.reset();
+}
+
 auto Stroke::isInSelection(ShapeContainer* container) -> bool {
     for (auto&& p: this->points) {
         double px = p.x;
@@ -113,7 +122,7 @@ void Stroke::setFirstPoint(double x, double y) {
         Point& p = this->points.front();
         p.x = x;
         p.y = y;
-        this->sizeCalculated = false;
+        pointsChanged();
     }
 }
 
@@ -122,22 +131,111 @@ void Stroke::setLastPoint(double x, double y) { setLastPoint({x, y}); }
 void Stroke::setLastPoint(const Point& p) {
     if (!this->points.empty()) {
         this->points.back() = p;
-        this->sizeCalculated = false;
+        pointsChanged();
     }
 }
 
 void Stroke::addPoint(const Point& p) {
     this->points.emplace_back(p);
-    this->sizeCalculated = false;
+    this->boundsTree.reset();
+
+    // While drawing, the size is requested after each point
+    if (this->sizeCalculated && this->points.size() > 1) {
+        extendSize(p);
+    } else {
+        this->sizeCalculated = false;
+    }
 }
 
 auto Stroke::getPointCount() const -> int { return this->points.size(); }
 
 auto Stroke::getPointVector() const -> std::vector<Point> const& { return points; }
 
-void Stroke::deletePointsFrom(int index) { points.resize(std::min(size_t(index), points.size())); }
+void Stroke::deletePointsFrom(int index) {
+    points.resize(std::min(size_t(index), points.size()));
+    pointsChanged();
+}
+
+void Stroke::deletePoint(int index) {
+    this->points.erase(std::next(begin(this->points), index));
+    pointsChanged();
+}
+
+void Stroke::setPointVector(std::vector<Point> points) {
+    this->points = std::move(points);
+    pointsChanged();
+}
+
+auto Stroke::simplify(double tolerance) -> bool {
+    size_t count = this->points.size();
+    if (count < 3 || tolerance <= 0) {
+        return false;
+    }
+
+    bool pressure = hasPressure();
+    std::vector<bool> keep(count, false);
+    keep.front() = true;
+    keep.back() = true;
+
+    // Iterative instead of recursive, long strokes would need a deep recursion
+    std::vector<std::pair<size_t, size_t>> ranges{{0, count - 1}};
+    while (!ranges.empty()) {
+        auto [first, last] = ranges.back();
+        ranges.pop_back();
+
+        const Point& a = this->points[first];
+        const Point& b = this->points[last];
+        double dx = b.x - a.x;
+        double dy = b.y - a.y;
+        double lengthSqrd = dx * dx + dy * dy;
+
+        double maxError = 0;
+        size_t maxIndex = first;
+        for (size_t i = first + 1; i < last; i++) {
+            const Point& p = this->points[i];
+
+            // Distance to the segment a - b
+            double t = 0;
+            if (lengthSqrd > 0) {
+                t = std::clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSqrd, 0.0, 1.0);
+            }
+            double error = std::hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+
+            if (pressure) {
+                // The segment a - b is drawn with the width of a
+                error = std::max(error, std::abs(p.z - a.z));
+            }
+
+            if (error > maxError) {
+                maxError = error;
+                maxIndex = i;
+            }
+        }
+
+        if (maxError > tolerance) {
+            keep[maxIndex] = true;
+            ranges.emplace_back(first, maxIndex);
+            ranges.emplace_back(maxIndex, last);
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (keep[i]) {
+            this->points[kept++] = this->points[i];
+        }
+    }
+
+    if (kept == count) {
+        return false;
+    }
+
+    this->points.resize(kept);
+    this->points.shrink_to_fit();
+    pointsChanged();
 
-void Stroke::deletePoint(int index) { this->points.erase(std::next(begin(this->points), index)); }
+    return true;
+}
 
 auto Stroke::getPoint(int index) const -> Point {
     if (index < 0 || index >= this->points.size()) {
@@ -160,12 +258,9 @@ void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
 void Stroke::move(double dx, double dy) {
-    for (auto&& point: points) {
-        point.x += dx;
-        point.y += dy;
-    }
+    PointKernels::translate(this->points.data(), this->points.size(), dx, dy);
 
-    this->sizeCalculated = false;
+    pointsChanged();
 }
 
 void Stroke::rotate(double x0, double y0, double th) {
@@ -175,9 +270,8 @@ void Stroke::rotate(double x0, double y0, double th) {
     cairo_matrix_rotate(&rotMatrix, th);
     cairo_matrix_translate(&rotMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
-        cairo_matrix_transform_point(&rotMatrix, &p.x, &p.y);
-    }
+    PointKernels::transform(this->points.data(), this->points.size(), rotMatrix);
+    this->boundsTree.reset();
     // Width and Height will likely be changed after this operation
     calcSize();
 }
@@ -192,16 +286,13 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     cairo_matrix_rotate(&scaleMatrix, -rotation);
     cairo_matrix_translate(&scaleMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
-        cairo_matrix_transform_point(&scaleMatrix, &p.x, &p.y);
-
-        if (p.z != Point::NO_PRESSURE) {
-            p.z *= fz;
-        }
+    PointKernels::transform(this->points.data(), this->points.size(), scaleMatrix);
+    if (fz != 1) {
+        PointKernels::scalePressure(this->points.data(), this->points.size(), fz);
     }
     this->width *= fz;
 
-    this->sizeCalculated = false;
+    pointsChanged();
 }
 
 auto Stroke::hasPressure() const -> bool {
@@ -221,20 +312,32 @@ void Stroke::scalePressure(double factor) {
     if (!hasPressure()) {
         return;
     }
-    for (auto&& p: this->points) {
-        p.z *= factor;
-    }
+    PointKernels::scalePressure(this->points.data(), this->points.size(), factor);
+    this->sizeCalculated = false;
 }
 
 void Stroke::clearPressure() {
     for (auto&& p: points) {
         p.z = Point::NO_PRESSURE;
     }
+    this->sizeCalculated = false;
 }
 
 void Stroke::setLastPressure(double pressure) {
-    if (!this->points.empty()) {
-        this->points.back().z = pressure;
+    if (this->points.empty()) {
+        return;
+    }
+
+    Point& last = this->points.back();
+    // While drawing, the pressure is set for the last point before the next one is added. The bounds only
+    // grow then, a lower pressure or the first point, which decides if the pressure is used, needs calcSize()
+    bool grows = last.z == Point::NO_PRESSURE || pressure >= last.z;
+    last.z = pressure;
+
+    if (this->sizeCalculated && grows && this->points.size() > 1) {
+        extendSize(last);
+    } else {
+        this->sizeCalculated = false;
     }
 }
 
@@ -249,6 +352,7 @@ void Stroke::setPressure(const vector<double>& pressure) {
     for (size_t i = 0U; i != max_size; ++i) {
         this->points[i].z = pressure[i];
     }
+    this->sizeCalculated = false;
 }
 
 /**
@@ -258,6 +362,16 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) -> bool {
     return intersects(x, y, halfEraserSize, nullptr);
 }
 
+auto Stroke::getBoundsTree() const -> const StrokeBoundsTree* {
+    if (this->points.size() < StrokeBoundsTree::MIN_POINTS) {
+        return nullptr;
+    }
+    if (!this->boundsTree) {
+        this->boundsTree = std::make_shared<const StrokeBoundsTree>(this->points);
+    }
+    return this->boundsTree.get();
+}
+
 /**
  * checks if the stroke is intersected by the eraser rectangle
  */
@@ -266,64 +380,106 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
         return false;
     }
 
+    const StrokeBoundsTree* tree = getBoundsTree();
+    if (tree == nullptr) {
+        for (size_t i = 0; i < this->points.size(); i++) {
+            if (segmentIntersects(i, x, y, halfEraserSize, gap)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A segment can only be hit if the center of the eraser is at most halfEraserSize from the line through the
+    // segment, and at most halfEraserSize * sqrt(2) + PADDING beyond its end points, see segmentIntersects()
+    double margin = halfEraserSize * (1 + std::sqrt(2)) + 0.1;
+    return tree->find(x - margin, y - margin, x + margin, y + margin, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            if (segmentIntersects(i, x, y, halfEraserSize, gap)) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+auto Stroke::segmentIntersects(size_t i, double x, double y, double halfEraserSize, double* gap) const -> bool {
     double x1 = x - halfEraserSize;
     double x2 = x + halfEraserSize;
     double y1 = y - halfEraserSize;
     double y2 = y + halfEraserSize;
 
-    double lastX = points[0].x;
-    double lastY = points[0].y;
-    for (auto&& point: points) {
-        double px = point.x;
-        double py = point.y;
+    double lastX = points[i > 0 ? i - 1 : 0].x;
+    double lastY = points[i > 0 ? i - 1 : 0].y;
+    double px = points[i].x;
+    double py = points[i].y;
 
-        if (px >= x1 && py >= y1 && px <= x2 && py <= y2) {
-            if (gap) {
-                *gap = 0;
-            }
-            return true;
+    if (px >= x1 && py >= y1 && px <= x2 && py <= y2) {
+        if (gap) {
+            *gap = 0;
         }
+        return true;
+    }
 
-        double len = hypot(px - lastX, py - lastY);
-        if (len >= halfEraserSize) {
-            /**
-             * The distance of the center of the eraser box to the line passing through (lastx, lasty) and (px, py)
-             */
-            double p = std::abs((x - lastX) * (lastY - py) + (y - lastY) * (px - lastX)) / len;
+    double len = hypot(px - lastX, py - lastY);
+    if (len >= halfEraserSize) {
+        /**
+         * The distance of the center of the eraser box to the line passing through (lastx, lasty) and (px, py)
+         */
+        double p = std::abs((x - lastX) * (lastY - py) + (y - lastY) * (px - lastX)) / len;
 
-            // If the distance p of the center of the eraser box to the (full) line is in the range,
-            // we check whether the eraser box is not too far from the line segment through the two points.
+        // If the distance p of the center of the eraser box to the (full) line is in the range,
+        // we check whether the eraser box is not too far from the line segment through the two points.
 
-            if (p <= halfEraserSize) {
-                double centerX = (lastX + px) / 2;
-                double centerY = (lastY + py) / 2;
-                double distance = hypot(x - centerX, y - centerY);
+        if (p <= halfEraserSize) {
+            double centerX = (lastX + px) / 2;
+            double centerY = (lastY + py) / 2;
+            double distance = hypot(x - centerX, y - centerY);
 
-                // For the above check we imagine a circle whose center is the mid point of the two points of the stroke
-                // and whose radius is half the length of the line segment plus half the diameter of the eraser box
-                // plus some small padding
-                // If the center of the eraser box lies within that circle then we consider it to be close enough
+            // For the above check we imagine a circle whose center is the mid point of the two points of the stroke
+            // and whose radius is half the length of the line segment plus half the diameter of the eraser box
+            // plus some small padding
+            // If the center of the eraser box lies within that circle then we consider it to be close enough
 
-                distance -= halfEraserSize * std::sqrt(2);
+            distance -= halfEraserSize * std::sqrt(2);
 
-                constexpr double PADDING = 0.1;
+            constexpr double PADDING = 0.1;
 
-                if (distance <= len / 2 + PADDING) {
-                    if (gap) {
-                        *gap = distance;
-                    }
-                    return true;
+            if (distance <= len / 2 + PADDING) {
+                if (gap) {
+                    *gap = distance;
                 }
+                return true;
             }
         }
-
-        lastX = px;
-        lastY = py;
     }
 
     return false;
 }
 
+void Stroke::extendSize(const Point& p) const {
+    // Like calcSize(), the first point decides if the pressure is used
+    bool hasPressure = this->points[0].z != Point::NO_PRESSURE;
+    double halfThick = (hasPressure ? p.z : this->width) / 2.0;
+
+    double minX = std::min(Element::x, p.x - halfThick);
+    double minY = std::min(Element::y, p.y - halfThick);
+    double maxX = std::max(Element::x + Element::width, p.x + halfThick);
+    double maxY = std::max(Element::y + Element::height, p.y + halfThick);
+
+    Element::x = minX;
+    Element::y = minY;
+    Element::width = maxX - minX;
+    Element::height = maxY - minY;
+
+    Rectangle<double>& snap = Element::snappedBounds;
+    double minSnapX = std::min(snap.x, p.x);
+    double minSnapY = std::min(snap.y, p.y);
+    double maxSnapX = std::max(snap.x + snap.width, p.x);
+    double maxSnapY = std::max(snap.y + snap.height, p.y);
+    snap = Rectangle<double>(minSnapX, minSnapY, maxSnapX - minSnapX, maxSnapY - minSnapY);
+}
+
 /**
  * Updates the size
  * The size is needed to only redraw the requested part instead of redrawing
@@ -341,45 +497,21 @@ void Stroke::calcSize() const {
 
         // used for snapping
         Element::snappedBounds = Rectangle<double>{};
+        return;
     }
 
-    double minX = DBL_MAX;
-    double maxX = DBL_MIN;
-    double minY = DBL_MAX;
-    double maxY = DBL_MIN;
-
-    double minSnapX = DBL_MAX;
-    double maxSnapX = DBL_MIN;
-    double minSnapY = DBL_MAX;
-    double maxSnapY = DBL_MIN;
-
     bool hasPressure = points[0].z != Point::NO_PRESSURE;
-    double halfThick = this->width / 2.0;  //  accommodate for pen width
-
-    for (auto&& p: points) {
-        if (hasPressure) {
-            halfThick = p.z / 2.0;
-        }
-
-        minX = std::min(minX, p.x - halfThick);
-        minY = std::min(minY, p.y - halfThick);
-
-        maxX = std::max(maxX, p.x + halfThick);
-        maxY = std::max(maxY, p.y + halfThick);
 
-        minSnapX = std::min(minSnapX, p.x);
-        minSnapY = std::min(minSnapY, p.y);
+    PointKernels::Bounds line{};
+    PointKernels::Bounds snap{};
+    PointKernels::calcBounds(this->points.data(), this->points.size(), this->width, hasPressure, line, snap);
 
-        maxSnapX = std::max(maxSnapX, p.x);
-        maxSnapY = std::max(maxSnapY, p.y);
-    }
-
-    Element::x = minX;
-    Element::y = minY;
-    Element::width = maxX - minX;
-    Element::height = maxY - minY;
+    Element::x = line.x1;
+    Element::y = line.y1;
+    Element::width = line.x2 - line.x1;
+    Element::height = line.y2 - line.y1;
 
-    Element::snappedBounds = Rectangle<double>(minSnapX, minSnapY, maxSnapX - minSnapX, maxSnapY - minSnapY);
+    Element::snappedBounds = Rectangle<double>(snap.x1, snap.y1, snap.x2 - snap.x1, snap.y2 - snap.y1);
 }
 
 auto Stroke::getEraseable() -> EraseableStroke* { return this->eraseable; }
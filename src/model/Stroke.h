@@ -11,10 +11,13 @@
 
 #pragma once
 
+#include <memory>
+
 #include "AudioElement.h"
 #include "Element.h"
 #include "LineStyle.h"
 #include "Point.h"
+#include "StrokeBoundsTree.h"
 
 enum StrokeTool { STROKE_TOOL_PEN, STROKE_TOOL_ERASER, STROKE_TOOL_HIGHLIGHTER };
 
@@ -72,6 +75,17 @@ public:
 
     void deletePoint(int index);
     void deletePointsFrom(int index);
+    void setPointVector(std::vector<Point> points);
+
+    /**
+     * Removes the points which are closer than the tolerance to the simplified stroke (Douglas-Peucker).
+     * For strokes with pressure, points whose width differs more than the tolerance from the width of the
+     * simplified segment are kept as well.
+     *
+     * @param tolerance The maximal error in document coordinates
+     * @return true if points were removed
+     */
+    bool simplify(double tolerance);
 
     void setToolType(StrokeTool type);
     StrokeTool getToolType() const;
@@ -109,6 +123,27 @@ public:
 protected:
     void calcSize() const override;
 
+private:
+    /**
+     * Tests the segment from point i - 1 to point i, see intersects()
+     */
+    bool segmentIntersects(size_t i, double x, double y, double halfEraserSize, double* gap) const;
+
+    /**
+     * Returns the bounds tree of the points, nullptr for short strokes
+     */
+    const StrokeBoundsTree* getBoundsTree() const;
+
+    /**
+     * Extends the calculated size by a new point, instead of calculating it again
+     */
+    void extendSize(const Point& p) const;
+
+    /**
+     * Called if the points were changed
+     */
+    void pointsChanged();
+
 private:
     // The stroke width cannot be inherited from Element
     double width = 0;
@@ -125,6 +160,11 @@ private:
 
     EraseableStroke* eraseable = nullptr;
 
+    /**
+     * Built on the first hit test of a long stroke, shared by copies of the stroke as it is immutable
+     */
+    mutable std::shared_ptr<const StrokeBoundsTree> boundsTree;
+
     /**
      * Option to fill the shape:
      *  -1: The shape is not filled
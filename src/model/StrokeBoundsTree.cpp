@@ -0,0 +1,44 @@
+#include "StrokeBoundsTree.h"
+
+#include <utility>
+
+StrokeBoundsTree::StrokeBoundsTree(const std::vector<Point>& points): pointCount(points.size()) {
+    if (points.empty()) {
+        return;
+    }
+
+    std::vector<Box> chunks;
+    chunks.reserve((points.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    for (size_t first = 0; first < points.size(); first += CHUNK_SIZE) {
+        // Including the start of the first segment of the chunk
+        const Point& start = points[first > 0 ? first - 1 : 0];
+        Box box{start.x, start.y, start.x, start.y};
+
+        size_t last = std::min(first + CHUNK_SIZE, points.size());
+        for (size_t i = first; i < last; i++) {
+            box.x1 = std::min(box.x1, points[i].x);
+            box.y1 = std::min(box.y1, points[i].y);
+            box.x2 = std::max(box.x2, points[i].x);
+            box.y2 = std::max(box.y2, points[i].y);
+        }
+        chunks.push_back(box);
+    }
+    this->levels.push_back(std::move(chunks));
+
+    while (this->levels.back().size() > 1) {
+        const std::vector<Box>& below = this->levels.back();
+
+        std::vector<Box> level;
+        level.reserve((below.size() + 1) / 2);
+        for (size_t i = 0; i < below.size(); i += 2) {
+            Box box = below[i];
+            if (i + 1 < below.size()) {
+                const Box& other = below[i + 1];
+                box = {std::min(box.x1, other.x1), std::min(box.y1, other.y1), std::max(box.x2, other.x2),
+                       std::max(box.y2, other.y2)};
+            }
+            level.push_back(box);
+        }
+        this->levels.push_back(std::move(level));
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * Xournal++
+ *
+ * Bounding box hierarchy over the segments of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "Point.h"
+
+/**
+ * Bounding boxes of chunks of consecutive stroke points, combined pairwise into a binary tree. Used to find the
+ * segments of a long stroke which are close to a position, without testing all of them.
+ *
+ * The segment ending at point i starts at point i - 1, so the box of a chunk also contains the point before it.
+ * The tree is immutable, it is rebuilt if the points change.
+ */
+class StrokeBoundsTree {
+public:
+    explicit StrokeBoundsTree(const std::vector<Point>& points);
+
+public:
+    /**
+     * Calls f(first, last) with the point range [first, last) of each chunk whose box intersects the rectangle,
+     * in the order of the points, until f returns true
+     *
+     * @return true if f returned true
+     */
+    template <typename F>
+    bool find(double x1, double y1, double x2, double y2, F f) const {
+        if (this->levels.empty()) {
+            return false;
+        }
+        return findInNode(this->levels.size() - 1, 0, {x1, y1, x2, y2}, f);
+    }
+
+    /**
+     * Strokes with less points are tested point by point
+     */
+    static constexpr size_t MIN_POINTS = 256;
+
+    static constexpr size_t CHUNK_SIZE = 32;
+
+private:
+    struct Box {
+        double x1;
+        double y1;
+        double x2;
+        double y2;
+
+        bool intersects(const Box& other) const {
+            return x1 <= other.x2 && other.x1 <= x2 && y1 <= other.y2 && other.y1 <= y2;
+        }
+    };
+
+    template <typename F>
+    bool findInNode(size_t level, size_t index, const Box& query, F& f) const {
+        if (!this->levels[level][index].intersects(query)) {
+            return false;
+        }
+
+        if (level == 0) {
+            size_t first = index * CHUNK_SIZE;
+            return f(first, std::min(first + CHUNK_SIZE, this->pointCount));
+        }
+
+        size_t child = 2 * index;
+        if (findInNode(level - 1, child, query, f)) {
+            return true;
+        }
+        return child + 1 < this->levels[level - 1].size() && findInNode(level - 1, child + 1, query, f);
+    }
+
+private:
+    /**
+     * levels[0] contains the boxes of the chunks, each level above combines two boxes of the level below,
+     * the last level is the root
+     */
+    std::vector<std::vector<Box>> levels;
+
+    size_t pointCount = 0;
+};
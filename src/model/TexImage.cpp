@@ -7,11 +7,24 @@
 
 #include "pixbuf-utils.h"
 
-TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) { this->sizeCalculated = true; }
+TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) {
+    this->sizeCalculated = true;
+    g_mutex_init(&this->renderCacheMutex);
+}
 
-TexImage::~TexImage() { freeImageAndPdf(); }
+TexImage::~TexImage() {
+    freeImageAndPdf();
+    g_mutex_clear(&this->renderCacheMutex);
+}
 
 void TexImage::freeImageAndPdf() {
+    setCachedRendering(nullptr);
+
+    if (this->pdfPage) {
+        g_object_unref(this->pdfPage);
+        this->pdfPage = nullptr;
+    }
+
     if (this->image) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
@@ -79,9 +92,9 @@ auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
         if (!pdf || poppler_document_get_n_pages(this->pdf) < 1) {
             return false;
         }
+        this->pdfPage = poppler_document_get_page(this->pdf, 0);
         if (!this->width && !this->height) {
-            PopplerPage* page = poppler_document_get_page(this->pdf, 0);
-            poppler_page_get_size(page, &this->width, &this->height);
+            poppler_page_get_size(this->pdfPage, &this->width, &this->height);
         }
     } else if (type == "PNG") {
         this->image = cairo_image_surface_create_from_png_stream(
@@ -97,6 +110,30 @@ auto TexImage::getImage() -> cairo_surface_t* { return this->image; }
 
 auto TexImage::getPdf() -> PopplerDocument* { return this->pdf; }
 
+auto TexImage::getPdfPage() -> PopplerPage* { return this->pdfPage; }
+
+auto TexImage::getCachedRendering(int width, int height) -> cairo_surface_t* {
+    cairo_surface_t* surface = nullptr;
+
+    g_mutex_lock(&this->renderCacheMutex);
+    if (this->renderCache && cairo_image_surface_get_width(this->renderCache) == width &&
+        cairo_image_surface_get_height(this->renderCache) == height) {
+        surface = cairo_surface_reference(this->renderCache);
+    }
+    g_mutex_unlock(&this->renderCacheMutex);
+
+    return surface;
+}
+
+void TexImage::setCachedRendering(cairo_surface_t* surface) {
+    g_mutex_lock(&this->renderCacheMutex);
+    if (this->renderCache) {
+        cairo_surface_destroy(this->renderCache);
+    }
+    this->renderCache = surface ? cairo_surface_reference(surface) : nullptr;
+    g_mutex_unlock(&this->renderCacheMutex);
+}
+
 void TexImage::scale(double x0, double y0, double fx, double fy, double rotation,
                      bool) {  // line width scaling option is not used
 
@@ -51,6 +51,23 @@ public:
      */
     PopplerDocument* getPdf();
 
+    /**
+     * @return The first page of the PDF Document, which is kept open as long as the PDF
+     */
+    PopplerPage* getPdfPage();
+
+    /**
+     * @return The cached rasterized PDF, if it has the requested size in pixels, else nullptr.
+     *
+     * The returned surface is referenced and needs to be destroyed by the caller
+     */
+    cairo_surface_t* getCachedRendering(int width, int height);
+
+    /**
+     * Replaces the cached rasterized PDF, the surface gets referenced
+     */
+    void setCachedRendering(cairo_surface_t* surface);
+
     virtual void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth);
     virtual void rotate(double x0, double y0, double th);
 
@@ -86,6 +103,21 @@ private:
      */
     PopplerDocument* pdf = nullptr;
 
+    /**
+     * First page of the PDF, only requested once
+     */
+    PopplerPage* pdfPage = nullptr;
+
+    /**
+     * Rasterized PDF at the last zoom used for drawing on screen
+     */
+    cairo_surface_t* renderCache = nullptr;
+
+    /**
+     * The element is rendered from the UI Thread and the render jobs
+     */
+    GMutex renderCacheMutex{};
+
     /**
      * Tex image, if rendered as image. Note: this is deprecated and subject to removal in a later version.
      */
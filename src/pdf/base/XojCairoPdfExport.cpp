@@ -1,8 +1,9 @@
 #include "XojCairoPdfExport.h"
 
-#include <map>
+#include <algorithm>
 #include <sstream>
 #include <stack>
+#include <thread>
 
 #include <cairo/cairo-pdf.h>
 
@@ -98,48 +99,227 @@ void XojCairoPdfExport::endPdf() {
     this->surface = nullptr;
 }
 
-void XojCairoPdfExport::exportPage(size_t page) {
-    PageRef p = doc->getPage(page);
+auto XojCairoPdfExport::backgroundKey(const PageRef& p) -> string {
+    PageType type = p->getBackgroundType();
+    bool backgroundVisible = p->isLayerVisible(0);
+
+    std::ostringstream key;
+    if (type.isPdfPage() && !noBackgroundExport) {
+        key << "pdf " << p->getPdfPageNr();
+    } else if (!backgroundVisible) {
+        key << "hidden";
+    } else if (noBackgroundExport || type.isPdfPage()) {
+        return "";
+    } else if (type.isImagePage()) {
+        // The pixbuf is shared by all copies of the image
+        key << "image " << static_cast<void*>(p->getBackgroundImage().getPixbuf());
+    } else {
+        key << "type " << static_cast<int>(type.format) << " " << type.config << " "
+            << uint32_t(p->getBackgroundColor());
+    }
 
-    cairo_pdf_surface_set_size(this->surface, p->getWidth(), p->getHeight());
+    if (type.isPdfPage() && !backgroundVisible) {
+        key << " hidden";
+    }
+    key << " " << p->getWidth() << "x" << p->getHeight();
 
-    DocumentView view;
+    return key.str();
+}
 
-    cairo_save(this->cr);
+void XojCairoPdfExport::drawBackground(cairo_t* cr, const PageRef& p) {
     if (p->getBackgroundType().isPdfPage() && !noBackgroundExport) {
-        int pgNo = p->getPdfPageNr();
-        XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
+        XojPdfPageSPtr popplerPage = doc->getPdfPage(p->getPdfPageNr());
+        if (popplerPage) {
+            popplerPage->render(cr, true);
+        }
+    }
+
+    DocumentView view;
+    view.initDrawing(p, cr, true /* dont render eraseable */);
+
+    bool backgroundVisible = p->isLayerVisible(0);
+    if (!noBackgroundExport && backgroundVisible) {
+        view.drawBackground();
+    }
+    if (!backgroundVisible) {
+        view.drawTransparentBackgroundPattern();
+    }
+
+    view.finializeDrawing();
+}
+
+void XojCairoPdfExport::paintBackground(cairo_t* cr, const PageRef& p) {
+    string key = backgroundKey(p);
+    if (key.empty()) {
+        return;
+    }
+
+    // Recording the paint also attaches a snapshot to the background, so this is locked as well
+    std::lock_guard<std::mutex> lock(this->backgroundMutex);
+
+    Background& background = this->backgrounds[key];
+    if (background.recording == nullptr) {
+        cairo_rectangle_t extents = {0, 0, p->getWidth(), p->getHeight()};
+        background.recording = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+        cairo_t* crBackground = cairo_create(background.recording);
+        drawBackground(crBackground, p);
+        cairo_destroy(crBackground);
+    }
+
+    cairo_set_source_surface(cr, background.recording, 0, 0);
+    cairo_paint(cr);
 
-        popplerPage->render(cr, true);
+    if (background.uses <= 1) {
+        // The page recordings keep their own reference
+        cairo_surface_destroy(background.recording);
+        this->backgrounds.erase(key);
+    } else {
+        background.uses--;
     }
+}
+
+auto XojCairoPdfExport::recordPage(const PageTask& task) -> cairo_surface_t* {
+    PageRef p = doc->getPage(task.page);
+
+    cairo_rectangle_t extents = {0, 0, p->getWidth(), p->getHeight()};
+    cairo_surface_t* recording = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+    cairo_t* cr = cairo_create(recording);
+
+    paintBackground(cr, p);
+
+    // The layers of the presentation mode are selected here instead of
+    // changing the layer visibility, which is shared by all threads
+    DocumentView view;
+    view.initDrawing(p, cr, true /* dont render eraseable */);
+
+    int layer = 0;
+    for (Layer* l: *p->getLayers()) {
+        if (task.layerCount >= 0 ? layer >= task.layerCount : !p->isLayerVisible(l)) {
+            continue;
+        }
+        view.drawLayer(cr, l);
+        layer++;
+    }
+
+    view.finializeDrawing();
+    cairo_destroy(cr);
+
+    return recording;
+}
+
+void XojCairoPdfExport::recordPages() {
+    std::unique_lock<std::mutex> lock(this->taskMutex);
+    while (true) {
+        this->taskCondition.wait(lock, [this] {
+            return this->nextTask >= this->tasks.size() || this->nextTask < this->written + this->window;
+        });
+        if (this->nextTask >= this->tasks.size()) {
+            return;
+        }
+
+        // Images decode their data and TeX images render their PDF page when drawn, which is not thread safe.
+        // The presentation mode draws the elements of a page several times, so a page is recorded by one worker.
+        size_t first = this->nextTask;
+        size_t last = first;
+        while (!this->tasks[last].lastOfPage) {
+            last++;
+        }
+        this->nextTask = last + 1;
+
+        for (size_t i = first; i <= last; i++) {
+            PageTask& task = this->tasks[i];
+
+            lock.unlock();
+            cairo_surface_t* recording = recordPage(task);
+            lock.lock();
+
+            task.recording = recording;
+            task.done = true;
+            this->taskCondition.notify_all();
+        }
+    }
+}
 
-    view.drawPage(p, this->cr, true /* dont render eraseable */, noBackgroundExport);
+void XojCairoPdfExport::writePage(PageTask& task) {
+    PageRef p = doc->getPage(task.page);
+
+    cairo_pdf_surface_set_size(this->surface, p->getWidth(), p->getHeight());
+
+    // The recording is replayed as vector graphic
+    cairo_save(this->cr);
+    cairo_set_source_surface(this->cr, task.recording, 0, 0);
+    cairo_paint(this->cr);
+    cairo_restore(this->cr);
 
     // next page
     cairo_show_page(this->cr);
-    cairo_restore(this->cr);
+
+    cairo_surface_destroy(task.recording);
+    task.recording = nullptr;
 }
 
-// export layers one by one to produce as many PDF pages as there are layers.
-void XojCairoPdfExport::exportPageLayers(size_t page) {
-    PageRef p = doc->getPage(page);
+void XojCairoPdfExport::exportPages(const std::vector<size_t>& pages, bool presentationMode) {
+    this->tasks.clear();
+    for (size_t page: pages) {
+        if (!presentationMode) {
+            this->tasks.push_back({page});
+            continue;
+        }
+
+        // We draw as many pages as there are layers. The first page has
+        // only Layer 1 visible, the last has all layers visible.
+        int layerCount = static_cast<int>(doc->getPage(page)->getLayers()->size());
+        for (int i = 1; i <= layerCount; i++) {
+            this->tasks.push_back({page, i, i == layerCount});
+        }
+    }
+
+    for (const PageTask& task: this->tasks) {
+        string key = backgroundKey(doc->getPage(task.page));
+        if (!key.empty()) {
+            this->backgrounds[key].uses++;
+        }
+    }
+
+    size_t threads = std::max(1U, std::thread::hardware_concurrency());
+    threads = std::min(threads, this->tasks.size());
+    this->nextTask = 0;
+    this->written = 0;
+    this->window = 2 * threads;
 
-    // We keep a copy of the layers initial Visible state
-    std::map<Layer*, bool> initialVisibility;
-    for (const auto& layer: *p->getLayers()) {
-        initialVisibility[layer] = layer->isVisible();
-        layer->setVisible(false);
+    std::vector<std::thread> workers;
+    if (threads > 1) {
+        for (size_t i = 0; i < threads; i++) {
+            workers.emplace_back(&XojCairoPdfExport::recordPages, this);
+        }
     }
 
-    // We draw as many pages as there are layers. The first page has
-    // only Layer 1 visible, the last has all layers visible.
-    for (const auto& layer: *p->getLayers()) {
-        layer->setVisible(true);
-        exportPage(page);
+    int exportedPages = 0;
+    for (PageTask& task: this->tasks) {
+        if (workers.empty()) {
+            task.recording = recordPage(task);
+        } else {
+            std::unique_lock<std::mutex> lock(this->taskMutex);
+            this->taskCondition.wait(lock, [&task] { return task.done; });
+        }
+
+        writePage(task);
+
+        if (!workers.empty()) {
+            std::lock_guard<std::mutex> lock(this->taskMutex);
+            this->written++;
+            this->taskCondition.notify_all();
+        }
+
+        if (task.lastOfPage && this->progressListener) {
+            this->progressListener->setCurrentState(exportedPages++);
+        }
     }
 
-    // We restore the initial visibilities
-    for (const auto& layer: *p->getLayers()) layer->setVisible(initialVisibility[layer]);
+    for (std::thread& t: workers) {
+        t.join();
+    }
+    this->tasks.clear();
 }
 
 auto XojCairoPdfExport::createPdf(fs::path const& file, PageRangeVector& range, bool presentationMode) -> bool {
@@ -152,34 +332,22 @@ auto XojCairoPdfExport::createPdf(fs::path const& file, PageRangeVector& range,
         return false;
     }
 
-    int count = 0;
-    for (PageRangeEntry* e: range) {
-        count += e->getLast() - e->getFirst() + 1;
-    }
-
-    if (this->progressListener) {
-        this->progressListener->setMaximumState(count);
-    }
-
-    int c = 0;
+    std::vector<size_t> pages;
     for (PageRangeEntry* e: range) {
         for (int i = e->getFirst(); i <= e->getLast(); i++) {
             if (i < 0 || i >= static_cast<int>(doc->getPageCount())) {
                 continue;
             }
-
-            if (presentationMode) {
-                exportPageLayers(i);
-            } else {
-                exportPage(i);
-            }
-
-            if (this->progressListener) {
-                this->progressListener->setCurrentState(c++);
-            }
+            pages.push_back(i);
         }
     }
 
+    if (this->progressListener) {
+        this->progressListener->setMaximumState(pages.size());
+    }
+
+    exportPages(pages, presentationMode);
+
     endPdf();
     return true;
 }
@@ -199,18 +367,11 @@ auto XojCairoPdfExport::createPdf(fs::path const& file, bool presentationMode) -
         this->progressListener->setMaximumState(count);
     }
 
+    std::vector<size_t> pages;
     for (int i = 0; i < count; i++) {
-
-        if (presentationMode) {
-            exportPageLayers(i);
-        } else {
-            exportPage(i);
-        }
-
-        if (this->progressListener) {
-            this->progressListener->setCurrentState(i);
-        }
+        pages.push_back(i);
     }
+    exportPages(pages, presentationMode);
 
     endPdf();
     return true;
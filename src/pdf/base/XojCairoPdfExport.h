@@ -11,6 +11,12 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "control/jobs/ProgressListener.h"
 #include "model/Document.h"
 
@@ -46,11 +52,65 @@ private:
     void populatePdfOutline(GtkTreeModel* tocModel);
 #endif
     void endPdf();
-    void exportPage(size_t page);
+
+    /**
+     * A page of the PDF, recorded by a worker thread and written in order
+     */
+    struct PageTask {
+        size_t page = 0;
+
+        /**
+         * In presentation mode the count of layers to draw, -1 to draw the visible layers
+         */
+        int layerCount = -1;
+
+        /**
+         * The last PDF page of this document page, for the progress
+         */
+        bool lastOfPage = true;
+
+        cairo_surface_t* recording = nullptr;
+        bool done = false;
+    };
+
+    /**
+     * Records the pages in parallel and writes them to the PDF in order
+     *
+     * @param presentationMode Export as a PDF document where each additional layer creates a new page
+     */
+    void exportPages(const std::vector<size_t>& pages, bool presentationMode);
+
+    /**
+     * Draws a page into a recording surface. Different pages can be recorded in parallel,
+     * the tasks of the same page share its elements and must be recorded by the same thread.
+     */
+    cairo_surface_t* recordPage(const PageTask& task);
+
+    /**
+     * Identifies the background of a page, pages with the same key share the background
+     *
+     * @return An empty string if nothing is drawn below the layers
+     */
+    string backgroundKey(const PageRef& p);
+
+    /**
+     * Draws everything below the layers: the PDF page, the page background or the
+     * pattern of a hidden background
+     */
+    void drawBackground(cairo_t* cr, const PageRef& p);
+
+    /**
+     * Paints the shared recording of the page background, thread safe
+     */
+    void paintBackground(cairo_t* cr, const PageRef& p);
+
     /**
-     * Export as a PDF document where each additional layer creates a
-     * new page */
-    void exportPageLayers(size_t page);
+     * Worker thread, records the pages within the window of pages in memory.
+     * All tasks of a page are recorded by the worker which takes its first task.
+     */
+    void recordPages();
+
+    void writePage(PageTask& task);
 
 private:
     Document* doc = nullptr;
@@ -62,4 +122,37 @@ private:
     bool noBackgroundExport = false;
 
     string lastError;
+
+    /**
+     * Protects tasks, nextTask and written
+     */
+    std::mutex taskMutex;
+    std::condition_variable taskCondition;
+    std::vector<PageTask> tasks;
+    size_t nextTask = 0;
+    size_t written = 0;
+
+    /**
+     * Count of recorded pages kept in memory, until they are written
+     */
+    size_t window = 0;
+
+    /**
+     * Each distinct background is recorded once. Painting the same recording on all
+     * pages makes cairo write it only once to the PDF, as form XObject.
+     */
+    struct Background {
+        cairo_surface_t* recording = nullptr;
+
+        /**
+         * Count of pages which still need the background, it is freed after the last one
+         */
+        size_t uses = 0;
+    };
+
+    /**
+     * Protects backgrounds. Also the pages of the background PDF are not rendered in parallel.
+     */
+    std::mutex backgroundMutex;
+    std::map<string, Background> backgrounds;
 };
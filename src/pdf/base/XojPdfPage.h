@@ -45,6 +45,14 @@ public:
 
     virtual vector<XojPdfRectangle> findText(string& text) = 0;
 
+    /**
+     * Extracts the text of the page
+     *
+     * @param glyphs Filled with the bounding box of each character of the returned text (UTF-8), in page
+     * coordinates
+     */
+    virtual string getTextLayout(vector<XojPdfRectangle>& glyphs) = 0;
+
     virtual int getPageId() = 0;
 
 private:
@@ -78,3 +78,26 @@ auto PopplerGlibPage::findText(string& text) -> vector<XojPdfRectangle> {
 
     return findings;
 }
+
+auto PopplerGlibPage::getTextLayout(vector<XojPdfRectangle>& glyphs) -> string {
+    glyphs.clear();
+
+    char* text = poppler_page_get_text(page);
+    if (text == nullptr) {
+        return "";
+    }
+
+    PopplerRectangle* rects = nullptr;
+    guint count = 0;
+    if (poppler_page_get_text_layout(page, &rects, &count)) {
+        glyphs.reserve(count);
+        for (guint i = 0; i < count; i++) {
+            glyphs.emplace_back(rects[i].x1, rects[i].y1, rects[i].x2, rects[i].y2);
+        }
+        g_free(rects);
+    }
+
+    string str = text;
+    g_free(text);
+    return str;
+}
@@ -31,6 +31,8 @@ public:
 
     virtual vector<XojPdfRectangle> findText(string& text);
 
+    virtual string getTextLayout(vector<XojPdfRectangle>& glyphs);
+
     virtual int getPageId();
 
 private:
@@ -27,8 +27,16 @@ AddUndoAction::~AddUndoAction() {
 }
 
 void AddUndoAction::addElement(Layer* layer, Element* e, int pos) {
-    this->elements = g_list_insert_sorted(this->elements, new PageLayerPosEntry<Element>(layer, e, pos),
-                                          reinterpret_cast<GCompareFunc>(PageLayerPosEntry<Element>::cmp));
+    // Sorted once on undo / redo, sorting on each insert is quadratic for large selections
+    this->elements = g_list_prepend(this->elements, new PageLayerPosEntry<Element>(layer, e, pos));
+    this->sorted = false;
+}
+
+void AddUndoAction::sortElements() {
+    if (!this->sorted) {
+        this->elements = PageLayerPosEntry<Element>::sort(this->elements);
+        this->sorted = true;
+    }
 }
 
 auto AddUndoAction::redo(Control*) -> bool {
@@ -39,9 +47,10 @@ auto AddUndoAction::redo(Control*) -> bool {
         return false;
     }
 
+    sortElements();
+    PageLayerPosEntry<Element>::insertAll(this->elements);
     for (GList* l = this->elements; l != nullptr; l = l->next) {
         auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
-        e->layer->insertElement(e->element, e->pos);
         this->page->fireElementChanged(e->element);
     }
 
@@ -57,9 +66,9 @@ auto AddUndoAction::undo(Control*) -> bool {
         return false;
     }
 
+    PageLayerPosEntry<Element>::removeAll(this->elements);
     for (GList* l = this->elements; l != nullptr; l = l->next) {
         auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
-        e->layer->removeElement(e->element, false);
         this->page->fireElementChanged(e->element);
     }
 
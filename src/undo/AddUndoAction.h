@@ -34,7 +34,11 @@ public:
 
     string getText() override;
 
+private:
+    void sortElements();
+
 private:
     GList* elements = nullptr;
+    bool sorted = true;
     bool eraser = false;
 };
@@ -25,8 +25,16 @@ DeleteUndoAction::~DeleteUndoAction() {
 }
 
 void DeleteUndoAction::addElement(Layer* layer, Element* e, int pos) {
-    this->elements = g_list_insert_sorted(this->elements, new PageLayerPosEntry<Element>(layer, e, pos),
-                                          reinterpret_cast<GCompareFunc>(PageLayerPosEntry<Element>::cmp));
+    // Sorted once on undo / redo, sorting on each insert is quadratic for large selections
+    this->elements = g_list_prepend(this->elements, new PageLayerPosEntry<Element>(layer, e, pos));
+    this->sorted = false;
+}
+
+void DeleteUndoAction::sortElements() {
+    if (!this->sorted) {
+        this->elements = PageLayerPosEntry<Element>::sort(this->elements);
+        this->sorted = true;
+    }
 }
 
 auto DeleteUndoAction::undo(Control*) -> bool {
@@ -37,9 +45,10 @@ auto DeleteUndoAction::undo(Control*) -> bool {
         return false;
     }
 
+    sortElements();
+    PageLayerPosEntry<Element>::insertAll(this->elements);
     for (GList* l = this->elements; l != nullptr; l = l->next) {
         auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
-        e->layer->insertElement(e->element, e->pos);
         this->page->fireElementChanged(e->element);
     }
 
@@ -55,9 +64,9 @@ auto DeleteUndoAction::redo(Control*) -> bool {
         return false;
     }
 
+    PageLayerPosEntry<Element>::removeAll(this->elements);
     for (GList* l = this->elements; l != nullptr; l = l->next) {
         auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
-        e->layer->removeElement(e->element, false);
         this->page->fireElementChanged(e->element);
     }
 
@@ -11,6 +11,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <glib.h>
+
+#include "model/Layer.h"
+
 template <class T>
 class PageLayerPosEntry {
 public:
@@ -29,4 +37,40 @@ public:
     int pos;
 
     static int cmp(PageLayerPosEntry<T>* a, PageLayerPosEntry<T>* b) { return a->pos - b->pos; }
+
+    /**
+     * Sorts a list built with g_list_prepend() by the position,
+     * entries with the same position keep the order they were added
+     */
+    static GList* sort(GList* entries) {
+        return g_list_sort(g_list_reverse(entries), reinterpret_cast<GCompareFunc>(cmp));
+    }
+
+    /**
+     * Inserts the elements of the sorted entries, with one batch per Layer
+     */
+    static void insertAll(GList* entries) {
+        std::map<Layer*, Layer::IndexedElements> layers;
+        for (GList* l = entries; l != nullptr; l = l->next) {
+            auto e = static_cast<PageLayerPosEntry<T>*>(l->data);
+            layers[e->layer].emplace_back(e->element, std::max(e->pos, 0));
+        }
+        for (auto const& [layer, elements]: layers) {
+            layer->insertElements(elements);
+        }
+    }
+
+    /**
+     * Removes the elements of the entries, with one batch per Layer
+     */
+    static void removeAll(GList* entries) {
+        std::map<Layer*, std::vector<Element*>> layers;
+        for (GList* l = entries; l != nullptr; l = l->next) {
+            auto e = static_cast<PageLayerPosEntry<T>*>(l->data);
+            layers[e->layer].push_back(e->element);
+        }
+        for (auto const& [layer, elements]: layers) {
+            layer->removeElements(elements);
+        }
+    }
 };
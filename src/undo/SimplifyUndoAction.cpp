@@ -0,0 +1,54 @@
+#include "SimplifyUndoAction.h"
+
+#include <utility>
+
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+#include "i18n.h"
+
+SimplifyUndoAction::SimplifyUndoAction(): UndoAction("SimplifyUndoAction") {}
+
+SimplifyUndoAction::~SimplifyUndoAction() = default;
+
+void SimplifyUndoAction::addStroke(const PageRef& page, Stroke* s, std::vector<Point> originalPoints) {
+    this->data.push_back({page, s, std::move(originalPoints)});
+}
+
+auto SimplifyUndoAction::isEmpty() const -> bool { return this->data.empty(); }
+
+void SimplifyUndoAction::swapPoints() {
+    for (Entry& e: this->data) {
+        std::vector<Point> current = e.s->getPointVector();
+        e.s->setPointVector(std::move(e.points));
+        e.points = std::move(current);
+    }
+
+    for (const PageRef& p: getPages()) {
+        p->firePageChanged();
+    }
+}
+
+auto SimplifyUndoAction::undo(Control* control) -> bool {
+    swapPoints();
+    this->undone = true;
+    return true;
+}
+
+auto SimplifyUndoAction::redo(Control* control) -> bool {
+    swapPoints();
+    this->undone = false;
+    return true;
+}
+
+auto SimplifyUndoAction::getPages() -> vector<PageRef> {
+    vector<PageRef> pages;
+    for (const Entry& e: this->data) {
+        if (pages.empty() || pages.back() != e.page) {
+            pages.push_back(e.page);
+        }
+    }
+    return pages;
+}
+
+auto SimplifyUndoAction::getText() -> string { return _("Simplify strokes"); }
@@ -0,0 +1,55 @@
+/*
+ * Xournal++
+ *
+ * Undo action for stroke simplification
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "model/Point.h"
+
+#include "UndoAction.h"
+
+class Stroke;
+
+class SimplifyUndoAction: public UndoAction {
+public:
+    SimplifyUndoAction();
+    virtual ~SimplifyUndoAction();
+
+public:
+    virtual bool undo(Control* control);
+    virtual bool redo(Control* control);
+    virtual string getText();
+    virtual vector<PageRef> getPages();
+
+    /**
+     * Adds a stroke, which is already simplified
+     */
+    void addStroke(const PageRef& page, Stroke* s, std::vector<Point> originalPoints);
+
+    bool isEmpty() const;
+
+private:
+    void swapPoints();
+
+private:
+    struct Entry {
+        PageRef page;
+        Stroke* s;
+
+        /**
+         * The points which are currently not in the stroke
+         */
+        std::vector<Point> points;
+    };
+
+    std::vector<Entry> data;
+};
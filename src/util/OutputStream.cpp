@@ -1,8 +1,8 @@
 #include "OutputStream.h"
 
+#include <algorithm>
 #include <cstdlib>
 
-#include "GzUtil.h"
 #include "i18n.h"
 
 OutputStream::OutputStream() = default;
@@ -13,31 +13,180 @@ void OutputStream::write(const string& str) { write(str.c_str(), str.length());
 
 void OutputStream::write(const char* str) { write(str, strlen(str)); }
 
+void OutputStream::setBinaryContent(bool binary) {}
+
 ////////////////////////////////////////////////////////
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(fs::path file): file(std::move(file)) {
-    this->fp = GzUtil::openPath(this->file, "w");
-    if (this->fp == nullptr) {
+/**
+ * Size of the independently compressed blocks. Each block restarts the deflate dictionary,
+ * which costs less than 0.1% of the file size at this size.
+ */
+constexpr size_t GZ_BLOCK_SIZE = 1024 * 1024;
+
+GzOutputStream::GzOutputStream(fs::path file, int compressionLevel):
+        compressionLevel(compressionLevel), file(std::move(file)), current(std::make_unique<Block>()) {
+    this->fp.open(this->file, std::ios::binary | std::ios::trunc);
+    if (!this->fp.is_open()) {
         this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
     }
 }
 
-GzOutputStream::~GzOutputStream() {
-    if (this->fp) {
-        close();
+GzOutputStream::~GzOutputStream() { close(); }
+
+auto GzOutputStream::getLastError() -> string& { return this->error; }
+
+void GzOutputStream::write(const char* data, int len) {
+    if (!this->fp.is_open()) {
+        // The error is already set, no blocks are compressed
+        return;
+    }
+
+    while (len > 0) {
+        size_t count = std::min<size_t>(len, GZ_BLOCK_SIZE - this->current->input.size());
+        this->current->input.append(data, count);
+        if (this->binary) {
+            this->binaryBytes += count;
+        }
+        data += count;
+        len -= count;
+
+        if (this->current->input.size() >= GZ_BLOCK_SIZE) {
+            flushBlock(false);
+        }
     }
-    this->fp = nullptr;
 }
 
-auto GzOutputStream::getLastError() -> string& { return this->error; }
+void GzOutputStream::setBinaryContent(bool binary) { this->binary = binary; }
+
+void GzOutputStream::compress(Block& block, int level) {
+    z_stream stream{};
+    // 16 + 15: gzip header, maximal window size
+    if (deflateInit2(&stream, level, Z_DEFLATED, 16 + 15, 8, block.strategy) != Z_OK) {
+        return;
+    }
+
+    block.output.resize(deflateBound(&stream, block.input.size()));
+    stream.next_in = reinterpret_cast<Bytef*>(&block.input[0]);
+    stream.avail_in = block.input.size();
+    stream.next_out = reinterpret_cast<Bytef*>(&block.output[0]);
+    stream.avail_out = block.output.size();
+
+    if (deflate(&stream, Z_FINISH) == Z_STREAM_END) {
+        block.output.resize(stream.total_out);
+    } else {
+        block.output.clear();
+    }
+    deflateEnd(&stream);
+
+    block.input.clear();
+    block.input.shrink_to_fit();
+}
+
+void GzOutputStream::compressBlocks() {
+    std::unique_lock<std::mutex> lock(this->blockMutex);
+    while (true) {
+        this->blockCondition.wait(lock, [this] { return this->closing || !this->todo.empty(); });
+        if (this->todo.empty()) {
+            return;
+        }
+
+        std::shared_ptr<Block> block = this->todo.front();
+        this->todo.pop_front();
+
+        lock.unlock();
+        compress(*block, this->compressionLevel);
+        lock.lock();
+
+        block->done = true;
+        this->blockCondition.notify_all();
+    }
+}
+
+void GzOutputStream::flushBlock(bool last) {
+    auto block = std::shared_ptr<Block>(std::move(this->current));
+    this->current = std::make_unique<Block>();
 
-void GzOutputStream::write(const char* data, int len) { gzwrite(this->fp, data, len); }
+    // Base64 encoded PNG or PDF data has no repeated strings to find, but Huffman coding
+    // still removes the base64 overhead, at a fraction of the cost
+    if (this->binaryBytes * 2 > block->input.size()) {
+        block->strategy = Z_HUFFMAN_ONLY;
+    }
+    this->binaryBytes = 0;
+
+    if (this->workers.empty() && this->pending.empty() && last) {
+        // Everything fits into one block
+        compress(*block, this->compressionLevel);
+        block->done = true;
+        this->pending.push_back(block);
+        writeBlocks(0);
+        return;
+    }
+
+    size_t threads = std::max(1U, std::thread::hardware_concurrency());
+    if (this->workers.empty()) {
+        for (size_t i = 0; i < threads; i++) {
+            this->workers.emplace_back(&GzOutputStream::compressBlocks, this);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->blockMutex);
+        this->pending.push_back(block);
+        this->todo.push_back(block);
+    }
+    this->blockCondition.notify_all();
+
+    // Limits the memory usage, if writing is slower than compressing
+    writeBlocks(2 * threads);
+}
+
+void GzOutputStream::writeBlocks(size_t maxPending) {
+    std::unique_lock<std::mutex> lock(this->blockMutex);
+    while (!this->pending.empty()) {
+        if (this->pending.size() <= maxPending && !this->pending.front()->done) {
+            return;
+        }
+        this->blockCondition.wait(lock, [this] { return this->pending.front()->done; });
+
+        std::shared_ptr<Block> block = this->pending.front();
+        this->pending.pop_front();
+
+        lock.unlock();
+        if (block->output.empty() && this->error.empty()) {
+            this->error = FS(_F("Error compressing file: \"{1}\"") % this->file.u8string());
+        }
+        this->fp.write(block->output.data(), block->output.size());
+        lock.lock();
+    }
+}
 
 void GzOutputStream::close() {
-    if (this->fp) {
-        gzclose(this->fp);
-        this->fp = nullptr;
+    if (this->fp.is_open()) {
+        flushBlock(true);
+    }
+
+    // Only after the last block is queued, the workers stop as soon as no blocks are left
+    {
+        std::lock_guard<std::mutex> lock(this->blockMutex);
+        this->closing = true;
+    }
+    this->blockCondition.notify_all();
+
+    writeBlocks(0);
+
+    for (std::thread& t: this->workers) {
+        t.join();
+    }
+    this->workers.clear();
+
+    if (!this->fp.is_open()) {
+        return;
+    }
+
+    this->fp.close();
+    if (this->fp.fail() && this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->file.u8string());
     }
 }
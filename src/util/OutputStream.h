@@ -11,7 +11,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <zlib.h>
@@ -29,26 +35,78 @@ public:
     virtual void write(const char* data, int len) = 0;
     virtual void write(const string& str);
 
+    /**
+     * Marks the following data as already compressed (e.g. base64 encoded PNG images),
+     * streams may store it with less effort
+     */
+    virtual void setBinaryContent(bool binary);
+
     virtual void close() = 0;
 };
 
+/**
+ * Writes a gzip file. The data is split into blocks, which are deflated in parallel and written as
+ * concatenated gzip members. zlib (and every other gzip reader) reads them as one stream.
+ */
 class GzOutputStream: public OutputStream {
 public:
-    GzOutputStream(fs::path file);
+    GzOutputStream(fs::path file, int compressionLevel = Z_DEFAULT_COMPRESSION);
     virtual ~GzOutputStream();
 
 public:
     virtual void write(const char* data, int len);
+    virtual void setBinaryContent(bool binary);
 
     virtual void close();
 
     string& getLastError();
 
 private:
-    gzFile fp = nullptr;
+    struct Block {
+        string input;
+        string output;
+        int strategy = Z_DEFAULT_STRATEGY;
+        bool done = false;
+    };
+
+    /**
+     * Queues the current block for compression
+     *
+     * @param last No more data follows, a single block is compressed on the calling thread
+     */
+    void flushBlock(bool last);
+
+    /**
+     * Writes the compressed blocks in order, until at most maxPending blocks are left
+     */
+    void writeBlocks(size_t maxPending);
+
+    void compressBlocks();
+    static void compress(Block& block, int level);
+
+private:
+    std::ofstream fp;
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
 
     string error;
 
-    string target;
     fs::path file;
+
+    std::unique_ptr<Block> current;
+    size_t binaryBytes = 0;
+    bool binary = false;
+
+    /**
+     * The workers are started with the second block, small files are compressed on the calling thread
+     */
+    std::vector<std::thread> workers;
+    std::mutex blockMutex;
+    std::condition_variable blockCondition;
+
+    /**
+     * All blocks which are not written yet, in file order
+     */
+    std::deque<std::shared_ptr<Block>> pending;
+    std::deque<std::shared_ptr<Block>> todo;
+    bool closing = false;
 };
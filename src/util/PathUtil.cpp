@@ -198,6 +198,21 @@ auto Util::getCacheFile(const fs::path& relativeFileName) -> fs::path {
     return p;
 }
 
+auto Util::getThumbnailCacheFolder(const fs::path& document) -> fs::path {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(document, ec);
+    if (ec) {
+        absolute = document;
+    }
+
+    gchar* key = g_compute_checksum_for_string(G_CHECKSUM_SHA1, absolute.u8string().c_str(), -1);
+    fs::path p = getCacheSubfolder("thumbnails");
+    p /= key;
+    g_free(key);
+
+    return p;
+}
+
 auto Util::getTmpDirSubfolder(const fs::path& subfolder) -> fs::path {
     auto p = fs::u8path(g_get_tmp_dir());
     p /= FS(_F("xournalpp-{1}") % Util::getPid());
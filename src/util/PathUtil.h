@@ -119,4 +119,10 @@ void openFileWithFilebrowser(const fs::path& filename);
 [[maybe_unused]] [[nodiscard]] fs::path getTmpDirSubfolder(const fs::path& subfolder = "");
 [[maybe_unused]] [[nodiscard]] fs::path getAutosaveFilepath();
 
+/**
+ * Return the thumbnail cache folder of a document, shared by the sidebar and the thumbnailer.
+ * The folder itself is not created.
+ */
+[[maybe_unused]] [[nodiscard]] fs::path getThumbnailCacheFolder(const fs::path& document);
+
 }  // namespace Util
@@ -90,6 +90,36 @@ auto XojPreviewExtractor::readPreview(char* buffer, int len) -> PreviewExtractRe
     return PREVIEW_RESULT_ERROR_READING_PREVIEW;
 }
 
+/**
+ * Try to read the preview from the thumbnail cache
+ * @param file .xoj File
+ * @return true if the cached preview is newer than the file and was read
+ */
+auto XojPreviewExtractor::readCachedPreview(const fs::path& file) -> bool {
+    fs::path preview = Util::getThumbnailCacheFolder(file) / "preview.png";
+
+    std::error_code ec;
+    auto fileTime = fs::last_write_time(file, ec);
+    if (ec) {
+        return false;
+    }
+    auto previewTime = fs::last_write_time(preview, ec);
+    if (ec || previewTime < fileTime) {
+        return false;
+    }
+
+    gchar* contents = nullptr;
+    gsize len = 0;
+    if (!g_file_get_contents(preview.u8string().c_str(), &contents, &len, nullptr)) {
+        return false;
+    }
+
+    g_free(this->data);
+    this->data = reinterpret_cast<unsigned char*>(contents);
+    this->dataLen = len;
+    return true;
+}
+
 /**
  * Try to read the preview from file
  * @param file .xoj File
@@ -100,6 +130,12 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
     if (!Util::hasXournalFileExt(file)) {
         return PREVIEW_RESULT_BAD_FILE_EXTENSION;
     }
+
+    // Xournal++ stores a larger preview in the thumbnail cache on saving
+    if (readCachedPreview(file)) {
+        return PREVIEW_RESULT_IMAGE_READ;
+    }
+
     // read the new file format
     int zipError = 0;
     zip_t* zipFp = zip_open(file.u8string().c_str(), ZIP_RDONLY, &zipError);
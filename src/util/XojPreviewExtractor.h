@@ -74,6 +74,14 @@ public:
      */
     unsigned char* getData(gsize& dataLen);
 
+private:
+    /**
+     * Try to read the preview from the thumbnail cache, which is written by Xournal++ on saving
+     * @param file .xoj File
+     * @return true if an up to date preview was read
+     */
+    bool readCachedPreview(const fs::path& file);
+
     // Member
 private:
     /**
@@ -12,72 +12,112 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
 #include <limits>
 #include <mutex>
+#include <utility>
 #include <vector>
 
+/**
+ * Single producer / single consumer ring buffer
+ *
+ * One side of the queue is a PortAudio callback, which runs in a realtime thread. Pushing and popping
+ * samples therefore never takes a lock: the producer only writes the write position and the consumer
+ * only writes the read position. The mutex and the condition variables are only used by the other
+ * side, to sleep until samples or space are available.
+ */
 template <typename T>
 class AudioQueue {
 public:
+    AudioQueue(): buffer(CAPACITY) {}
+
+    /**
+     * Only call this if neither the producer nor the consumer is running
+     */
     void reset() {
-        std::lock_guard<std::mutex> lock(internalLock);
         this->popNotified = false;
         this->pushNotified = false;
         this->streamEnd = false;
-        internalQueue.clear();
+        this->readPos = 0;
+        this->writePos = 0;
 
         this->sampleRate = -1;
         this->channels = 0;
     }
 
-    bool empty() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.empty();
-    }
+    bool empty() { return size() == 0; }
 
     size_t size() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.size();
+        return this->writePos.load(std::memory_order_acquire) - this->readPos.load(std::memory_order_acquire);
     }
 
+    /**
+     * Called by the producer. If the queue is full, the samples which do not fit anymore are dropped.
+     *
+     * @return The number of samples stored
+     */
     template <typename Iter>
-    void emplace(Iter begI, Iter endI) {
-        std::lock_guard<std::mutex> lock(internalLock);
-        std::move(begI, endI, std::front_inserter(internalQueue));
+    size_t emplace(Iter begI, Iter endI) {
+        size_t write = this->writePos.load(std::memory_order_relaxed);
+        size_t read = this->readPos.load(std::memory_order_acquire);
+
+        size_t count = std::distance(begI, endI);
+        size_t space = CAPACITY - (write - read);
+        if (count > space) {
+            // Only store complete frames
+            unsigned int ch = std::max(1U, this->channels.load(std::memory_order_relaxed));
+            count = space - space % ch;
+        }
+
+        // Copy in up to two blocks, if the data wraps around the end of the buffer
+        size_t start = write & MASK;
+        size_t first = std::min(count, CAPACITY - start);
+        auto midI = std::next(begI, first);
+        std::copy(begI, midI, std::next(this->buffer.begin(), start));
+        std::copy(midI, std::next(begI, count), this->buffer.begin());
+
+        this->writePos.store(write + count, std::memory_order_release);
 
         this->pushNotified = true;
         this->pushLockCondition.notify_one();
+        return count;
     }
 
+    /**
+     * Called by the consumer, only complete frames are returned
+     */
     template <typename InsertIter>
     InsertIter pop(InsertIter insertIter, size_t nSamples) {
-        std::lock_guard<std::mutex> lock(internalLock);
-
-        if (this->channels == 0) {
+        unsigned int ch = this->channels.load(std::memory_order_relaxed);
+        if (ch == 0) {
             this->popNotified = true;
             this->popLockCondition.notify_one();
             return insertIter;
         }
 
+        size_t read = this->readPos.load(std::memory_order_relaxed);
+        size_t write = this->writePos.load(std::memory_order_acquire);
+
+        size_t queueSize = write - read;
+        size_t count = std::min<size_t>(nSamples, queueSize - queueSize % ch);
 
-        auto queueSize = internalQueue.size();
-        auto returnBufferLength = std::min<size_t>(nSamples, queueSize - queueSize % this->channels);
-        auto begI = rbegin(internalQueue);
-        auto endI = std::next(begI, returnBufferLength);
+        size_t start = read & MASK;
+        size_t first = std::min(count, CAPACITY - start);
+        auto begI = std::next(this->buffer.begin(), start);
+        insertIter = std::copy(begI, std::next(begI, first), insertIter);
+        insertIter = std::copy(this->buffer.begin(), std::next(this->buffer.begin(), count - first), insertIter);
 
-        auto ret = std::move(begI, endI, insertIter);
-        internalQueue.erase(endI.base(), begI.base());
+        this->readPos.store(read + count, std::memory_order_release);
 
         this->popNotified = true;
         this->popLockCondition.notify_one();
-        return ret;
+        return insertIter;
     }
 
     void signalEndOfStream() {
-        std::lock_guard<std::mutex> lock(internalLock);
         this->streamEnd = true;
         this->pushNotified = true;
         this->popNotified = true;
@@ -85,38 +125,34 @@ public:
         this->popLockCondition.notify_one();
     }
 
+    /**
+     * The producer does not take the lock to notify, so a notification may be missed.
+     * The timeout limits the delay in this case.
+     */
     void waitForProducer(std::unique_lock<std::mutex>& lock) {
         // static_assert(lock.mutex() == &this->queueLock);
         assert(lock.mutex() == &this->queueLock);
-        while (!this->pushNotified && !hasStreamEnded()) {
-            this->pushLockCondition.wait(lock);
+        while (!this->pushNotified.exchange(false) && !hasStreamEnded()) {
+            this->pushLockCondition.wait_for(lock, NOTIFY_TIMEOUT);
         }
-        this->pushNotified = false;
     }
 
+    /**
+     * See waitForProducer()
+     */
     void waitForConsumer(std::unique_lock<std::mutex>& lock) {
         // static_assert(lock.mutex() == &this->queueLock);
         assert(lock.mutex() == &this->queueLock);
-        while (!this->popNotified && !hasStreamEnded()) {
-            this->popLockCondition.wait(lock);
+        while (!this->popNotified.exchange(false) && !hasStreamEnded()) {
+            this->popLockCondition.wait_for(lock, NOTIFY_TIMEOUT);
         }
-        this->popNotified = false;
     }
 
-    bool hasStreamEnded() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return this->streamEnd;
-    }
+    bool hasStreamEnded() { return this->streamEnd; }
 
-    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() {
-        std::unique_lock retLock{this->queueLock, std::defer_lock};
-        std::lock(retLock, this->internalLock);
-        std::lock_guard{this->internalLock, std::adopt_lock};
-        return retLock;
-    }
+    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() { return std::unique_lock{this->queueLock}; }
 
     void setAudioAttributes(double lSampleRate, unsigned int lChannels) {
-        std::lock_guard<std::mutex> lock(internalLock);
         this->sampleRate = lSampleRate;
         this->channels = lChannels;
     }
@@ -126,23 +162,35 @@ public:
      * std::pair<double, int>::first is the sample rate and std::pair<double, int>::second the channel count.
      */
     [[nodiscard]] std::pair<double, int> getAudioAttributes() {
-        std::lock_guard<std::mutex> lock(internalLock);
         return {this->sampleRate, static_cast<int>(this->channels)};
     }
 
 private:
+    /**
+     * About 5 seconds of stereo audio at 48 kHz, must be a power of two
+     */
+    static constexpr size_t CAPACITY = size_t{1} << 19U;
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    static constexpr std::chrono::milliseconds NOTIFY_TIMEOUT{10};
+
     std::mutex queueLock;
-    std::mutex internalLock;
 
-    std::deque<T> internalQueue;
+    std::vector<T> buffer;
+
+    /**
+     * Total number of samples written / read, the position in the buffer is masked
+     */
+    std::atomic<size_t> writePos{0};
+    std::atomic<size_t> readPos{0};
 
     std::condition_variable pushLockCondition;
     std::condition_variable popLockCondition;
 
-    double sampleRate{std::numeric_limits<double>::quiet_NaN()};
-    unsigned int channels{0};
+    std::atomic<double> sampleRate{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<unsigned int> channels{0};
 
-    bool streamEnd{false};
-    bool pushNotified{false};
-    bool popNotified{false};
+    std::atomic<bool> streamEnd{false};
+    std::atomic<bool> pushNotified{false};
+    std::atomic<bool> popNotified{false};
 };
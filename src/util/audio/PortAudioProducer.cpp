@@ -85,7 +85,9 @@ auto PortAudioProducer::recordCallback(const void* inputBuffer, void* /*outputBu
     if (inputBuffer != nullptr) {
         size_t providedFrames = framesPerBuffer * this->inputChannels;
         auto begI = static_cast<float const*>(inputBuffer);
-        this->audioQueue.emplace(begI, std::next(begI, providedFrames));
+        if (this->audioQueue.emplace(begI, std::next(begI, providedFrames)) < providedFrames) {
+            g_warning("PortAudioProducer: The encoder does not keep up, audio samples were dropped");
+        }
     }
     return paContinue;
 }
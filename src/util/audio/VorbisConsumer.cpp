@@ -2,6 +2,12 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
+
+/**
+ * Number of frames passed to the encoder at once
+ */
+constexpr int WRITE_FRAMES = 4096;
 
 auto VorbisConsumer::start(const string& filename) -> bool {
     auto [sampleRate, channels] = this->audioQueue.getAudioAttributes();
@@ -27,21 +33,24 @@ auto VorbisConsumer::start(const string& filename) -> bool {
 
     this->consumerThread = std::thread([this, sfFile = std::move(sfFile), channels = channels] {
         auto lock{audioQueue.acquire_lock()};
-        auto buffer_size{static_cast<size_t>(std::max(0, 64 * channels))};
-        std::vector<float> buffer;
-        buffer.reserve(buffer_size);  // efficiency
+        auto buffer_size{static_cast<size_t>(std::max(0, WRITE_FRAMES * channels))};
+        std::vector<float> buffer(buffer_size);
         double audioGain = this->settings.getAudioGain();
 
         while (!(this->stopConsumer || (audioQueue.hasStreamEnded() && audioQueue.empty()))) {
             audioQueue.waitForProducer(lock);
-            while (audioQueue.size() > buffer_size || (audioQueue.hasStreamEnded() && !audioQueue.empty())) {
-                buffer.resize(0);
-                this->audioQueue.pop(std::back_inserter(buffer), buffer_size);
+            while (audioQueue.size() >= buffer_size || (audioQueue.hasStreamEnded() && !audioQueue.empty())) {
+                auto endI = this->audioQueue.pop(buffer.data(), buffer_size);
+                auto samples = static_cast<size_t>(std::distance(buffer.data(), endI));
+                if (samples == 0) {
+                    break;
+                }
+
                 // apply gain
                 if (audioGain != 1.0) {
-                    std::for_each(begin(buffer), end(buffer), [audioGain](auto& val) { val *= audioGain; });
+                    std::for_each(buffer.data(), endI, [audioGain](auto& val) { val *= audioGain; });
                 }
-                sf_writef_float(sfFile.get(), buffer.data(), std::min<size_t>(buffer.size() / channels, 64));
+                sf_writef_float(sfFile.get(), buffer.data(), samples / channels);
             }
         }
     });
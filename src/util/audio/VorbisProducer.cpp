@@ -1,38 +1,135 @@
 #include "VorbisProducer.h"
 
+#include <algorithm>
+
 constexpr auto sample_buffer_size = size_t{16384U};
 
-auto VorbisProducer::start(const std::string& filename, unsigned int timestamp) -> bool {
-    SF_INFO sfInfo{};
-    auto SNDFILE_tag_deleter = [](SNDFILE_tag* p) { sf_close(p); };
-    std::unique_ptr<SNDFILE_tag, decltype(SNDFILE_tag_deleter)> sfFile = {sf_open(filename.c_str(), SFM_READ, &sfInfo),
-                                                                          SNDFILE_tag_deleter};
-    if (!sfFile) {
+/**
+ * Number of recordings which are kept open
+ */
+constexpr size_t MAX_OPEN_FILES = 4;
+
+/**
+ * Audio decoded at the start of a playback, which is kept for the next playback from the same position
+ */
+constexpr sf_count_t PREFETCH_MS = 500;
+constexpr size_t MAX_PREFETCHED_BLOCKS = 32;
+
+auto VorbisProducer::openFile(const std::string& filename) -> std::shared_ptr<OpenFile> {
+    std::error_code ec;
+    fs::file_time_type lastWrite = fs::last_write_time(fs::u8path(filename), ec);
+
+    for (auto it = this->openFiles.begin(); it != this->openFiles.end(); ++it) {
+        if ((*it)->filename != filename) {
+            continue;
+        }
+
+        if ((*it)->lastWrite == lastWrite) {
+            this->openFiles.splice(this->openFiles.begin(), this->openFiles, it);
+            return this->openFiles.front();
+        }
+
+        // The file was written since it was opened, e.g. the recording was still running
+        this->openFiles.erase(it);
+        break;
+    }
+
+    auto file = std::make_shared<OpenFile>();
+    file->filename = filename;
+    file->lastWrite = lastWrite;
+    file->file.reset(sf_open(filename.c_str(), SFM_READ, &file->info));
+    if (!file->file) {
         g_warning("VorbisProducer: input file \"%s\" could not be opened\ncaused by:%s", filename.c_str(),
-                  sf_strerror(sfFile.get()));
-        return false;
+                  sf_strerror(nullptr));
+        return nullptr;
+    }
+
+    this->openFiles.push_front(file);
+    if (this->openFiles.size() > MAX_OPEN_FILES) {
+        this->openFiles.pop_back();
+    }
+
+    return file;
+}
+
+auto VorbisProducer::findPrefetched(OpenFile& file, sf_count_t frame) -> const PrefetchedBlock* {
+    auto it = std::find_if(file.prefetched.begin(), file.prefetched.end(),
+                           [frame](const PrefetchedBlock& b) { return b.frame == frame; });
+    if (it == file.prefetched.end()) {
+        return nullptr;
+    }
+
+    std::rotate(file.prefetched.begin(), it, std::next(it));
+    return &file.prefetched.front();
+}
+
+void VorbisProducer::storePrefetched(OpenFile& file, PrefetchedBlock block) {
+    file.prefetched.push_front(std::move(block));
+    if (file.prefetched.size() > MAX_PREFETCHED_BLOCKS) {
+        file.prefetched.pop_back();
+    }
+}
+
+void VorbisProducer::seekFile(OpenFile& file, sf_count_t frame) {
+    if (file.position == frame) {
+        return;
     }
 
-    sf_count_t seekPosition = sfInfo.samplerate / 1000 * timestamp;
+    sf_count_t position = sf_seek(file.file.get(), frame, SEEK_SET);
+    // A negative position is never equal to a requested one, so the next playback seeks again
+    file.position = position;
+}
+
+auto VorbisProducer::start(const std::string& filename, unsigned int timestamp) -> bool {
+    std::shared_ptr<OpenFile> file = openFile(filename);
+    if (!file) {
+        return false;
+    }
 
-    if (seekPosition < sfInfo.frames) {
-        sf_seek(sfFile.get(), seekPosition, SEEK_SET);
-    } else {
+    SF_INFO const sfInfo = file->info;
+    sf_count_t startFrame = static_cast<sf_count_t>(sfInfo.samplerate) * timestamp / 1000;
+    if (startFrame >= sfInfo.frames) {
         g_warning("VorbisProducer: Seeking outside of audio file extent");
+        startFrame = 0;
     }
 
     this->audioQueue.setAudioAttributes(sfInfo.samplerate, static_cast<unsigned int>(sfInfo.channels));
 
-    this->producerThread = std::thread([this, sfInfo, sfFile = std::move(sfFile)] {
+    // Playing from the same position again: the beginning is available without decoding
+    sf_count_t readFrame = startFrame;
+    size_t prefetchSize = static_cast<size_t>(sfInfo.samplerate * PREFETCH_MS / 1000) * sfInfo.channels;
+    if (const PrefetchedBlock* block = findPrefetched(*file, startFrame)) {
+        this->audioQueue.emplace(block->samples.begin(), block->samples.end());
+        readFrame += static_cast<sf_count_t>(block->samples.size()) / sfInfo.channels;
+        prefetchSize = 0;
+    }
+
+    this->producerThread = std::thread([this, sfInfo, file, startFrame, readFrame, prefetchSize] {
         size_t numFrames{1};
         size_t const bufferSize{size_t(1024U) * sfInfo.channels};
         std::vector<float> sampleBuffer(bufferSize);
         auto lock = audioQueue.acquire_lock();
 
+        seekFile(*file, readFrame);
+
+        PrefetchedBlock prefetch{startFrame, {}};
+        prefetch.samples.reserve(prefetchSize);
+        bool prefetching = prefetchSize > 0;
+
         while (!this->stopProducer && numFrames > 0 && !this->audioQueue.hasStreamEnded()) {
             sampleBuffer.resize(bufferSize);
-            numFrames = sf_readf_float(sfFile.get(), sampleBuffer.data(), 1024);
+            numFrames = sf_readf_float(file->file.get(), sampleBuffer.data(), 1024);
             sampleBuffer.resize(numFrames * sfInfo.channels);
+            if (file->position >= 0) {
+                file->position += static_cast<sf_count_t>(numFrames);
+            }
+
+            if (prefetching) {
+                size_t count = std::min(prefetchSize - prefetch.samples.size(), sampleBuffer.size());
+                prefetch.samples.insert(prefetch.samples.end(), sampleBuffer.begin(),
+                                        std::next(sampleBuffer.begin(), count));
+                prefetching = prefetch.samples.size() < prefetchSize && numFrames > 0;
+            }
 
             while (this->audioQueue.size() >= sample_buffer_size && !this->audioQueue.hasStreamEnded() &&
                    !this->stopProducer) {
@@ -40,12 +137,19 @@ auto VorbisProducer::start(const std::string& filename, unsigned int timestamp)
             }
 
             if (auto tmpSeekSeconds = this->seekSeconds.load(); tmpSeekSeconds != 0) {
-                sf_seek(sfFile.get(), tmpSeekSeconds * sfInfo.samplerate, SEEK_CUR);
+                file->position = sf_seek(file->file.get(), tmpSeekSeconds * sfInfo.samplerate, SEEK_CUR);
                 this->seekSeconds -= tmpSeekSeconds;
+                // The following samples do not continue the prefetched block anymore
+                prefetching = false;
             }
 
             this->audioQueue.emplace(begin(sampleBuffer), end(sampleBuffer));
         }
+
+        if (!prefetch.samples.empty()) {
+            storePrefetched(*file, std::move(prefetch));
+        }
+
         this->audioQueue.signalEndOfStream();
     });
     return true;
@@ -12,13 +12,19 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <sndfile.h>
 
 #include "AudioQueue.h"
 #include "DeviceInfo.h"
+#include "filesystem.h"
 
 struct VorbisProducer final {
     explicit VorbisProducer(AudioQueue<float>& audioQueue): audioQueue(audioQueue) {}
@@ -28,10 +34,58 @@ struct VorbisProducer final {
     void stop();
     void seek(int seconds);
 
+private:
+    /**
+     * Decoded audio from a start position of a previous playback
+     */
+    struct PrefetchedBlock {
+        sf_count_t frame = 0;
+        std::vector<float> samples;
+    };
+
+    /**
+     * A recently played file. It is kept open, so tapping the next stroke of the same recording
+     * neither needs to parse the header again nor to seek from the beginning of the file.
+     */
+    struct OpenFile {
+        struct Closer {
+            void operator()(SNDFILE* file) { sf_close(file); }
+        };
+
+        std::string filename;
+        fs::file_time_type lastWrite;
+        std::unique_ptr<SNDFILE, Closer> file;
+        SF_INFO info{};
+
+        /**
+         * The position of the decoder, to avoid seeking if the playback continues where the last one stopped
+         */
+        sf_count_t position = 0;
+
+        /**
+         * Most recently used first
+         */
+        std::deque<PrefetchedBlock> prefetched;
+    };
+
+    /**
+     * Returns the file from the cache, or opens it. Only called while the producer thread is not running.
+     */
+    std::shared_ptr<OpenFile> openFile(const std::string& filename);
+
+    static const PrefetchedBlock* findPrefetched(OpenFile& file, sf_count_t frame);
+    static void storePrefetched(OpenFile& file, PrefetchedBlock block);
+    static void seekFile(OpenFile& file, sf_count_t frame);
+
 private:
     AudioQueue<float>& audioQueue;
     std::thread producerThread{};
 
     std::atomic<bool> stopProducer{false};
     std::atomic<int> seekSeconds{0};
+
+    /**
+     * Most recently used first
+     */
+    std::list<std::shared_ptr<OpenFile>> openFiles;
 };
@@ -1,5 +1,8 @@
 #include "DocumentView.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "background/MainBackgroundPainter.h"
 #include "control/tools/EditSelection.h"
 #include "control/tools/Selection.h"
@@ -10,6 +13,11 @@
 #include "TextView.h"
 
 
+/**
+ * Larger formulas are rendered as vector graphic
+ */
+constexpr double TEX_IMAGE_MAX_RASTER_PIXELS = 4096.0 * 4096.0;
+
 DocumentView::DocumentView() { this->backgroundPainter = new MainBackgroundPainter(); }
 
 DocumentView::~DocumentView() {
@@ -22,6 +30,8 @@ DocumentView::~DocumentView() {
  */
 void DocumentView::setMarkAudioStroke(bool markAudioStroke) { this->markAudioStroke = markAudioStroke; }
 
+void DocumentView::setDraftMode(bool draftMode) { this->draftMode = draftMode; }
+
 void DocumentView::applyColor(cairo_t* cr, Stroke* s) {
     if (s->getToolType() == STROKE_TOOL_HIGHLIGHTER) {
         if (s->getFill() != -1) {
@@ -54,7 +64,7 @@ void DocumentView::drawStroke(cairo_t* cr, Stroke* s, int startPoint, double sca
         sv.changeCairoSource(this->markAudioStroke);
     }
 
-    sv.paint(this->dontRenderEditingStroke);
+    sv.paint(this->dontRenderEditingStroke, this->draftMode);
 }
 
 void DocumentView::drawText(cairo_t* cr, Text* t) {
@@ -89,6 +99,53 @@ void DocumentView::drawImage(cairo_t* cr, Image* i) {
     cairo_set_matrix(cr, &defaultMatrix);
 }
 
+auto DocumentView::getTexImageRaster(cairo_t* cr, TexImage* texImage) -> cairo_surface_t* {
+    cairo_surface_t* target = cairo_get_target(cr);
+    if (cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE) {
+        // PDF export and printing keep the vector graphic
+        return nullptr;
+    }
+
+    double dx = 1;
+    double dy = 0;
+    cairo_user_to_device_distance(cr, &dx, &dy);
+    double deviceScaleX = 1;
+    double deviceScaleY = 1;
+    cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+    double pixelScale = std::hypot(dx, dy) * deviceScaleX;
+    if (pixelScale <= 0) {
+        return nullptr;
+    }
+
+    // Zoom steps of 2^(1/4), so the formula is not rasterized again on every small zoom change
+    double scale = std::exp2(std::ceil(std::log2(pixelScale) * 4) / 4);
+    double width = std::ceil(texImage->getElementWidth() * scale);
+    double height = std::ceil(texImage->getElementHeight() * scale);
+    if (width < 1 || height < 1 || width * height > TEX_IMAGE_MAX_RASTER_PIXELS) {
+        return nullptr;
+    }
+
+    cairo_surface_t* raster = texImage->getCachedRendering(width, height);
+    if (raster) {
+        return raster;
+    }
+
+    PopplerPage* page = texImage->getPdfPage();
+    double pageWidth = 0;
+    double pageHeight = 0;
+    poppler_page_get_size(page, &pageWidth, &pageHeight);
+
+    raster = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* crRaster = cairo_create(raster);
+    cairo_scale(crRaster, width / pageWidth, height / pageHeight);
+    poppler_page_render(page, crRaster);
+    cairo_destroy(crRaster);
+
+    texImage->setCachedRendering(raster);
+
+    return raster;
+}
+
 void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) {
     cairo_matrix_t defaultMatrix = {0};
     cairo_get_matrix(cr, &defaultMatrix);
@@ -97,23 +154,35 @@ void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) {
     cairo_surface_t* img = texImage->getImage();
 
     if (pdf != nullptr) {
-        if (poppler_document_get_n_pages(pdf) < 1) {
+        PopplerPage* page = texImage->getPdfPage();
+        if (page == nullptr) {
             g_warning("Got latex PDf without pages!: %s", texImage->getText().c_str());
             return;
         }
 
-        PopplerPage* page = poppler_document_get_page(pdf, 0);
+        cairo_translate(cr, texImage->getX(), texImage->getY());
 
-        double pageWidth = 0;
-        double pageHeight = 0;
-        poppler_page_get_size(page, &pageWidth, &pageHeight);
+        if (cairo_surface_t* raster = getTexImageRaster(cr, texImage)) {
+            double xFactor = texImage->getElementWidth() / cairo_image_surface_get_width(raster);
+            double yFactor = texImage->getElementHeight() / cairo_image_surface_get_height(raster);
 
-        double xFactor = texImage->getElementWidth() / pageWidth;
-        double yFactor = texImage->getElementHeight() / pageHeight;
+            cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+            cairo_scale(cr, xFactor, yFactor);
+            cairo_set_source_surface(cr, raster, 0, 0);
+            cairo_paint(cr);
 
-        cairo_translate(cr, texImage->getX(), texImage->getY());
-        cairo_scale(cr, xFactor, yFactor);
-        poppler_page_render(page, cr);
+            cairo_surface_destroy(raster);
+        } else {
+            double pageWidth = 0;
+            double pageHeight = 0;
+            poppler_page_get_size(page, &pageWidth, &pageHeight);
+
+            double xFactor = texImage->getElementWidth() / pageWidth;
+            double yFactor = texImage->getElementHeight() / pageHeight;
+
+            cairo_scale(cr, xFactor, yFactor);
+            poppler_page_render(page, cr);
+        }
     } else if (img != nullptr) {
         int width = cairo_image_surface_get_width(img);
         int height = cairo_image_surface_get_height(img);
@@ -132,8 +201,17 @@ void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) {
     cairo_set_matrix(cr, &defaultMatrix);
 }
 
+void DocumentView::drawElementBox(cairo_t* cr, Element* e) {
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    applyColor(cr, e, 60);
+    cairo_rectangle(cr, e->getX(), e->getY(), e->getElementWidth(), e->getElementHeight());
+    cairo_fill(cr);
+}
+
 void DocumentView::drawElement(cairo_t* cr, Element* e) const {
-    if (e->getType() == ELEMENT_STROKE) {
+    if (this->draftMode && (e->getType() == ELEMENT_TEXT || e->getType() == ELEMENT_TEXIMAGE)) {
+        drawElementBox(cr, e);
+    } else if (e->getType() == ELEMENT_STROKE) {
         drawStroke(cr, dynamic_cast<Stroke*>(e));
     } else if (e->getType() == ELEMENT_TEXT) {
         drawText(cr, dynamic_cast<Text*>(e));
@@ -330,3 +408,26 @@ void DocumentView::drawPage(PageRef page, cairo_t* cr, bool dontRenderEditingStr
 
     finializeDrawing();
 }
+
+void DocumentView::drawPageLayers(PageRef page, cairo_t* cr, size_t first, size_t last, bool background) {
+    initDrawing(page, cr, false);
+
+    if (background) {
+        if (page->isLayerVisible(0)) {
+            drawBackground();
+        } else {
+            drawTransparentBackgroundPattern();
+        }
+    }
+
+    vector<Layer*>* layers = page->getLayers();
+    last = std::min(last, layers->size());
+    for (size_t i = first; i < last; i++) {
+        Layer* l = (*layers)[i];
+        if (page->isLayerVisible(l)) {
+            drawLayer(cr, l);
+        }
+    }
+
+    finializeDrawing();
+}
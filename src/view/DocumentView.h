@@ -44,6 +44,16 @@ public:
      */
     void drawPage(PageRef page, cairo_t* cr, bool dontRenderEditingStroke, bool hideBackground = false);
 
+    /**
+     * Draw the visible layers [first, last) of the page, in the same way as drawPage()
+     * @param page The page to draw
+     * @param cr Draw to thgis context
+     * @param first Index of the first layer in XojPage::getLayers()
+     * @param last Index after the last layer
+     * @param background true to draw the background (or the transparent pattern) first
+     */
+    void drawPageLayers(PageRef page, cairo_t* cr, size_t first, size_t last, bool background);
+
 
     void drawStroke(cairo_t* cr, Stroke* s, int startPoint = 0, double scaleFactor = 1, bool changeSource = true,
                     bool noAlpha = false) const;
@@ -61,6 +71,11 @@ public:
      */
     void setMarkAudioStroke(bool markAudioStroke);
 
+    /**
+     * Draw a fast approximation of the page: strokes without pressure, text and formulas as boxes
+     */
+    void setDraftMode(bool draftMode);
+
     // API for special drawing, usually you won't call this methods
 public:
     /**
@@ -98,8 +113,18 @@ private:
     static void drawImage(cairo_t* cr, Image* i);
     static void drawTexImage(cairo_t* cr, TexImage* texImage);
 
+    /**
+     * Returns the cached rasterized formula for the current zoom, nullptr to draw it as vector graphic
+     */
+    static cairo_surface_t* getTexImageRaster(cairo_t* cr, TexImage* texImage);
+
     void drawElement(cairo_t* cr, Element* e) const;
 
+    /**
+     * Draft mode replacement for elements which are expensive to layout
+     */
+    static void drawElementBox(cairo_t* cr, Element* e);
+
     void paintBackgroundImage();
 
 private:
@@ -109,6 +134,7 @@ private:
     double height = 0;
     bool dontRenderEditingStroke = false;
     bool markAudioStroke = false;
+    bool draftMode = false;
 
     double lX = -1;
     double lY = -1;
@@ -124,7 +124,7 @@ void StrokeView::drawWithPressure() {
     }
 }
 
-void StrokeView::paint(bool dontRenderEditingStroke) {
+void StrokeView::paint(bool dontRenderEditingStroke, bool noPressure) {
     cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
     cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
 
@@ -135,7 +135,7 @@ void StrokeView::paint(bool dontRenderEditingStroke) {
     }
 
     // No pressure sensitivity, easy draw a line...
-    if (!s->hasPressure() || s->getToolType() == STROKE_TOOL_HIGHLIGHTER) {
+    if (noPressure || !s->hasPressure() || s->getToolType() == STROKE_TOOL_HIGHLIGHTER) {
         drawNoPressure();
     } else {
         drawWithPressure();
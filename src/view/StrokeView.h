@@ -21,7 +21,10 @@ public:
     ~StrokeView() = default;
 
 public:
-    void paint(bool dontRenderEditingStroke);
+    /**
+     * @param noPressure Draw the stroke with its base width, also if it has pressure values
+     */
+    void paint(bool dontRenderEditingStroke, bool noPressure = false);
 
     /**
      * Change cairo source, used to draw highlighter transparent,
@@ -1,5 +1,7 @@
 #include "TextView.h"
 
+#include <algorithm>
+
 #include "control/settings/Settings.h"
 #include "model/Text.h"
 #include "pdf/base/XojPdfPage.h"
@@ -95,6 +97,36 @@ auto TextView::findText(const Text* t, string& search) -> vector<XojPdfRectangle
     return list;
 }
 
+auto TextView::getCharacterBoxes(const Text* t) -> vector<XojPdfRectangle> {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+    cairo_t* cr = cairo_create(surface);
+
+    PangoLayout* layout = initPango(cr, t);
+    string str = t->getText();
+    pango_layout_set_text(layout, str.c_str(), str.length());
+
+    vector<XojPdfRectangle> boxes;
+    boxes.reserve(g_utf8_strlen(str.c_str(), str.length()));
+
+    for (const char* c = str.c_str(); *c != 0; c = g_utf8_next_char(c)) {
+        PangoRectangle rect = {0};
+        pango_layout_index_to_pos(layout, c - str.c_str(), &rect);
+
+        // Width is negative for right to left text
+        double x1 = static_cast<double>(std::min(rect.x, rect.x + rect.width)) / PANGO_SCALE + t->getX();
+        double x2 = static_cast<double>(std::max(rect.x, rect.x + rect.width)) / PANGO_SCALE + t->getX();
+        double y1 = static_cast<double>(rect.y) / PANGO_SCALE + t->getY();
+        double y2 = static_cast<double>(rect.y + rect.height) / PANGO_SCALE + t->getY();
+        boxes.emplace_back(x1, y1, x2, y2);
+    }
+
+    g_object_unref(layout);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    return boxes;
+}
+
 void TextView::calcSize(const Text* t, double& width, double& height) {
     cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
     cairo_t* cr = cairo_create(surface);
@@ -40,6 +40,11 @@ public:
      */
     static vector<XojPdfRectangle> findText(const Text* t, string& search);
 
+    /**
+     * Calculates the bounding box of each character (UTF-8) of a Text model, in page coordinates
+     */
+    static vector<XojPdfRectangle> getCharacterBoxes(const Text* t);
+
     /**
      * Initialize a Pango layout
      */
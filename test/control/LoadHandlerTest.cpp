@@ -10,9 +10,11 @@
  */
 
 #include <config-test.h>
+#include <config.h>
 
 #include "control/xojfile/LoadHandler.h"
 #include "control/xojfile/SaveHandler.h"
+#include "model/Image.h"
 #include "util/PathUtil.h"
 
 #ifdef TEST_CHECK_SPEED
@@ -48,6 +50,7 @@ class LoadHandlerTest: public CppUnit::TestFixture {
     CPPUNIT_TEST(testStroke);
     CPPUNIT_TEST(loadImage);
     CPPUNIT_TEST(testLoadStoreLoad);
+    CPPUNIT_TEST(testSharedImagesFileVersion);
 
 #ifdef __linux__
     CPPUNIT_TEST(testLoadStoreLoadGerman);
@@ -383,6 +386,62 @@ public:
         }
     }
 
+    /**
+     * Saves the document and loads it again
+     *
+     * @return The file version of the saved file
+     */
+    int saveAndLoadImages(Document* doc, bool sharePayloads, size_t imageCount) {
+        SaveHandler h;
+        h.setSharePayloads(sharePayloads);
+        h.prepareSave(doc);
+        auto tmp = Util::getTmpDirSubfolder() / "save-images.xopp";
+        h.saveTo(tmp);
+        CPPUNIT_ASSERT(h.getErrorMessage().empty());
+
+        LoadHandler handler;
+        Document* loaded = handler.loadDocument(tmp);
+        CPPUNIT_ASSERT(loaded != nullptr);
+
+        Layer* layer = (*loaded->getPage(0)->getLayers())[0];
+        size_t images = 0;
+        for (Element* e: *layer->getElements()) {
+            if (e->getType() == ELEMENT_IMAGE) {
+                CPPUNIT_ASSERT(dynamic_cast<Image*>(e)->getImage() != nullptr);
+                images++;
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(imageCount, images);
+
+        return handler.getFileVersion();
+    }
+
+    void testSharedImagesFileVersion() {
+        LoadHandler handler;
+        Document* doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/suite.xopp"));
+        CPPUNIT_ASSERT(doc != nullptr);
+        Layer* layer = (*doc->getPage(0)->getLayers())[0];
+
+        cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 16, 16);
+        cairo_t* cr = cairo_create(surface);
+        cairo_set_source_rgb(cr, 1, 0, 0);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+
+        auto* image = new Image();
+        image->setImage(surface);
+        image->setWidth(16);
+        image->setHeight(16);
+        layer->addElement(image);
+
+        // Without references the file can be opened by older releases
+        CPPUNIT_ASSERT_EQUAL(4, saveAndLoadImages(doc, true, 1));
+
+        layer->addElement(image->clone());
+        CPPUNIT_ASSERT_EQUAL(4, saveAndLoadImages(doc, false, 2));
+        CPPUNIT_ASSERT_EQUAL(FILE_FORMAT_VERSION, saveAndLoadImages(doc, true, 2));
+    }
+
 #ifdef __linux__
     void testLoadStoreLoadGerman() {
         constexpr auto testLocale = "de_DE.UTF-8";
@@ -0,0 +1,200 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <config-test.h>
+
+#include "model/PointKernels.h"
+
+#ifdef TEST_CHECK_SPEED
+#include "SpeedTest.cpp"
+#endif
+
+#include <cmath>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class PointKernelsTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(PointKernelsTest);
+
+#ifdef TEST_CHECK_SPEED
+    CPPUNIT_TEST(testSpeed);
+#endif
+
+    CPPUNIT_TEST(testTransform);
+    CPPUNIT_TEST(testTranslate);
+    CPPUNIT_TEST(testScalePressure);
+    CPPUNIT_TEST(testBounds);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    /**
+     * A stroke with an odd number of points, some without pressure
+     */
+    static std::vector<Point> createPoints(size_t count) {
+        std::vector<Point> points;
+        points.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            double t = static_cast<double>(i) / 7.0;
+            double z = i % 5 == 3 ? Point::NO_PRESSURE : 1.0 + std::sin(t);
+            points.emplace_back(100.0 * std::cos(t) - 20.0, 50.0 * std::sin(3.0 * t) + i * 0.01, z);
+        }
+        return points;
+    }
+
+    static cairo_matrix_t createMatrix() {
+        cairo_matrix_t matrix;
+        cairo_matrix_init_identity(&matrix);
+        cairo_matrix_translate(&matrix, 120.5, -33.25);
+        cairo_matrix_rotate(&matrix, 0.7);
+        cairo_matrix_scale(&matrix, 1.5, 0.8);
+        cairo_matrix_translate(&matrix, -120.5, 33.25);
+        return matrix;
+    }
+
+    static void assertSamePoints(const std::vector<Point>& expected, const std::vector<Point>& actual) {
+        CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            CPPUNIT_ASSERT_EQUAL(expected[i].x, actual[i].x);
+            CPPUNIT_ASSERT_EQUAL(expected[i].y, actual[i].y);
+            CPPUNIT_ASSERT_EQUAL(expected[i].z, actual[i].z);
+        }
+    }
+
+    void testTransform() {
+        cairo_matrix_t matrix = createMatrix();
+        std::vector<Point> expected = createPoints(1001);
+        std::vector<Point> actual = expected;
+
+        for (Point& p: expected) {
+            cairo_matrix_transform_point(&matrix, &p.x, &p.y);
+        }
+        PointKernels::transform(actual.data(), actual.size(), matrix);
+
+        assertSamePoints(expected, actual);
+    }
+
+    void testTranslate() {
+        std::vector<Point> expected = createPoints(1001);
+        std::vector<Point> actual = expected;
+
+        PointKernels::Scalar::translate(expected.data(), expected.size(), 3.5, -7.25);
+        PointKernels::translate(actual.data(), actual.size(), 3.5, -7.25);
+
+        assertSamePoints(expected, actual);
+    }
+
+    void testScalePressure() {
+        std::vector<Point> expected = createPoints(1001);
+        std::vector<Point> actual = expected;
+
+        PointKernels::Scalar::scalePressure(expected.data(), expected.size(), 1.75);
+        PointKernels::scalePressure(actual.data(), actual.size(), 1.75);
+
+        assertSamePoints(expected, actual);
+        CPPUNIT_ASSERT_EQUAL(Point::NO_PRESSURE, actual[3].z);
+    }
+
+    void testBounds() {
+        std::vector<Point> points = createPoints(1001);
+        for (bool usePressure: {false, true}) {
+            PointKernels::Bounds expectedLine{};
+            PointKernels::Bounds expectedSnap{};
+            PointKernels::Scalar::calcBounds(points.data(), points.size(), 2.0, usePressure, expectedLine,
+                                             expectedSnap);
+
+            PointKernels::Bounds line{};
+            PointKernels::Bounds snap{};
+            PointKernels::calcBounds(points.data(), points.size(), 2.0, usePressure, line, snap);
+
+            CPPUNIT_ASSERT_EQUAL(expectedLine.x1, line.x1);
+            CPPUNIT_ASSERT_EQUAL(expectedLine.y1, line.y1);
+            CPPUNIT_ASSERT_EQUAL(expectedLine.x2, line.x2);
+            CPPUNIT_ASSERT_EQUAL(expectedLine.y2, line.y2);
+
+            CPPUNIT_ASSERT_EQUAL(expectedSnap.x1, snap.x1);
+            CPPUNIT_ASSERT_EQUAL(expectedSnap.y1, snap.y1);
+            CPPUNIT_ASSERT_EQUAL(expectedSnap.x2, snap.x2);
+            CPPUNIT_ASSERT_EQUAL(expectedSnap.y2, snap.y2);
+        }
+
+        // A single point without pressure
+        PointKernels::Bounds line{};
+        PointKernels::Bounds snap{};
+        PointKernels::calcBounds(points.data(), 1, 4.0, false, line, snap);
+        CPPUNIT_ASSERT_EQUAL(points[0].x - 2.0, line.x1);
+        CPPUNIT_ASSERT_EQUAL(points[0].y + 2.0, line.y2);
+        CPPUNIT_ASSERT_EQUAL(points[0].x, snap.x2);
+    }
+
+#ifdef TEST_CHECK_SPEED
+    /**
+     * Compares the kernels with the loops Stroke used before, on a selection of 4 million points
+     */
+    void testSpeed() {
+        constexpr size_t POINTS = 4000000;
+        constexpr int ROUNDS = 20;
+
+        cairo_matrix_t matrix = createMatrix();
+        std::vector<Point> points = createPoints(POINTS);
+        SpeedTest speed;
+
+        speed.startTest("transform points with cairo_matrix_transform_point()");
+        for (int r = 0; r < ROUNDS; r++) {
+            for (Point& p: points) {
+                cairo_matrix_transform_point(&matrix, &p.x, &p.y);
+            }
+        }
+        speed.endTest();
+
+        speed.startTest("transform points with PointKernels::transform()");
+        for (int r = 0; r < ROUNDS; r++) {
+            PointKernels::transform(points.data(), points.size(), matrix);
+        }
+        speed.endTest();
+
+        PointKernels::Bounds line{};
+        PointKernels::Bounds snap{};
+
+        speed.startTest("calculate bounds with PointKernels::Scalar::calcBounds()");
+        for (int r = 0; r < ROUNDS; r++) {
+            PointKernels::Scalar::calcBounds(points.data(), points.size(), 2.0, true, line, snap);
+        }
+        speed.endTest();
+
+        speed.startTest("calculate bounds with PointKernels::calcBounds()");
+        for (int r = 0; r < ROUNDS; r++) {
+            PointKernels::calcBounds(points.data(), points.size(), 2.0, true, line, snap);
+        }
+        speed.endTest();
+
+        speed.startTest("scale pressure with PointKernels::Scalar::scalePressure()");
+        for (int r = 0; r < ROUNDS; r++) {
+            PointKernels::Scalar::scalePressure(points.data(), points.size(), r % 2 ? 2.0 : 0.5);
+        }
+        speed.endTest();
+
+        speed.startTest("scale pressure with PointKernels::scalePressure()");
+        for (int r = 0; r < ROUNDS; r++) {
+            PointKernels::scalePressure(points.data(), points.size(), r % 2 ? 2.0 : 0.5);
+        }
+        speed.endTest();
+    }
+#endif
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(PointKernelsTest);
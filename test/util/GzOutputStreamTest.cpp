@@ -0,0 +1,118 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <string>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <zlib.h>
+
+#include "OutputStream.h"
+#include "filesystem.h"
+
+class GzOutputStreamTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(GzOutputStreamTest);
+
+    CPPUNIT_TEST(testSingleBlock);
+    CPPUNIT_TEST(testManyBlocks);
+    CPPUNIT_TEST(testOpenFailed);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() { this->file = fs::temp_directory_path() / "xournalpp-GzOutputStreamTest.gz"; }
+
+    void tearDown() {
+        std::error_code ec;
+        fs::remove(this->file, ec);
+    }
+
+    static std::string createContent(size_t size) {
+        std::string content;
+        content.reserve(size);
+        for (size_t i = 0; content.size() < size; i++) {
+            content += "<stroke tool=\"pen\" width=\"" + std::to_string(i % 97) + "\">" + std::to_string(i * 31) +
+                       "</stroke>\n";
+        }
+        content.resize(size);
+        return content;
+    }
+
+    std::string readFile() {
+        std::string content;
+        gzFile fp = gzopen(this->file.u8string().c_str(), "rb");
+        CPPUNIT_ASSERT(fp != nullptr);
+
+        char buffer[64 * 1024];
+        int len = 0;
+        while ((len = gzread(fp, buffer, sizeof(buffer))) > 0) {
+            content.append(buffer, len);
+        }
+        gzclose(fp);
+        return content;
+    }
+
+    void testSingleBlock() {
+        std::string content = createContent(1000);
+
+        GzOutputStream out(this->file);
+        out.write(content.data(), content.size());
+        out.close();
+
+        CPPUNIT_ASSERT(out.getLastError().empty());
+        CPPUNIT_ASSERT(content == readFile());
+    }
+
+    /**
+     * Several blocks are compressed by the workers, closing the stream must wait for all of them
+     */
+    void testManyBlocks() {
+        std::string content = createContent(5 * 1024 * 1024 + 12345);
+
+        for (int i = 0; i < 20; i++) {
+            GzOutputStream out(this->file);
+            for (size_t pos = 0; pos < content.size(); pos += 100000) {
+                out.write(content.data() + pos, static_cast<int>(std::min<size_t>(100000, content.size() - pos)));
+            }
+            out.close();
+
+            CPPUNIT_ASSERT(out.getLastError().empty());
+            CPPUNIT_ASSERT(content == readFile());
+        }
+    }
+
+    /**
+     * Data written to a stream which could not be opened is discarded, closing and destroying it must not fail
+     */
+    void testOpenFailed() {
+        std::string content = createContent(3 * 1024 * 1024);
+
+        {
+            GzOutputStream out(this->file / "missing" / "file.gz");
+            CPPUNIT_ASSERT(!out.getLastError().empty());
+
+            out.write(content.data(), content.size());
+            out.close();
+            CPPUNIT_ASSERT(!out.getLastError().empty());
+        }
+
+        // Without close()
+        GzOutputStream out(this->file / "missing" / "file.gz");
+        out.write(content.data(), content.size());
+        CPPUNIT_ASSERT(!out.getLastError().empty());
+    }
+
+private:
+    fs::path file;
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(GzOutputStreamTest);